@@ -0,0 +1,78 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Bench.h"
+
+namespace
+{
+    std::atomic<size_t> allocation_count(0);
+    std::atomic<size_t> allocation_bytes(0);
+
+    void *counted_alloc(size_t size)
+    {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (void *ptr = std::malloc(size ? size : 1))
+            return ptr;
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(size_t size) { return counted_alloc(size); }
+void *operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace StaticNet
+{
+    namespace Bench
+    {
+        Options &options()
+        {
+            static Options opts;
+            return opts;
+        }
+
+        void parse_args(int argc, char *argv[])
+        {
+            Options &opts = options();
+            for (int i = 1; i < argc; i++)
+            {
+                if (!strcmp(argv[i], "--min-time") && i + 1 < argc)
+                    opts.min_time = atof(argv[++i]);
+                else if (!strcmp(argv[i], "--min-iterations") && i + 1 < argc)
+                    opts.min_iterations = strtoul(argv[++i], nullptr, 10);
+                else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+                    opts.threads.push_back(atoi(argv[++i]));
+                else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+                    opts.filter = argv[++i];
+            }
+
+            if (opts.threads.empty())
+            {
+#ifdef _OPENMP
+                int max_threads = omp_get_max_threads();
+#else
+                int max_threads = 1;
+#endif
+                for (int t = 1; t < max_threads; t *= 2)
+                    opts.threads.push_back(t);
+                opts.threads.push_back(max_threads);
+            }
+        }
+
+        size_t allocations()
+        {
+            return allocation_count.load(std::memory_order_relaxed);
+        }
+
+        size_t allocated_bytes()
+        {
+            return allocation_bytes.load(std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace StaticNet
+{
+    namespace Bench
+    {
+        // ------------------------------------------------------------
+        // Harness shared by the benchmark executables.
+        //
+        // Every measurement is printed as one JSON object per line so the
+        // output can be diffed or fed to a regression tracker as-is.
+        // ------------------------------------------------------------
+
+        struct Options
+        {
+            double min_time = 0.25;
+            size_t min_iterations = 3;
+            std::vector<int> threads;
+            std::string filter;
+        };
+
+        Options &options();
+        void parse_args(int argc, char *argv[]);
+
+        size_t allocations();
+        size_t allocated_bytes();
+
+        template <class F>
+        void run(const char *suite, const char *name, const std::string &shape, double flops, double bytes, F &&f)
+        {
+            using Clock = std::chrono::steady_clock;
+            const Options &opts = options();
+
+            if (!opts.filter.empty() && std::string(name).find(opts.filter) == std::string::npos)
+                return;
+
+            for (int threads : opts.threads)
+            {
+#ifdef _OPENMP
+                omp_set_num_threads(threads);
+#endif
+                f();
+
+                size_t iterations = 0;
+                size_t allocs = allocations();
+                size_t alloc_bytes = allocated_bytes();
+                auto begin = Clock::now();
+                double elapsed = 0.0;
+                while (iterations < opts.min_iterations || elapsed < opts.min_time)
+                {
+                    f();
+                    iterations++;
+                    elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+                }
+                allocs = allocations() - allocs;
+                alloc_bytes = allocated_bytes() - alloc_bytes;
+
+                double seconds = elapsed / iterations;
+                printf("{\"suite\": \"%s\", \"name\": \"%s\", \"shape\": \"%s\", \"threads\": %d, "
+                       "\"iterations\": %zu, \"ns_per_iter\": %.1f, \"gflops\": %.3f, \"gbps\": %.3f, "
+                       "\"allocs_per_iter\": %.2f, \"alloc_bytes_per_iter\": %.0f}\n",
+                       suite, name, shape.c_str(), threads,
+                       iterations, seconds * 1e9, flops / seconds * 1e-9, bytes / seconds * 1e-9,
+                       (double)allocs / iterations, (double)alloc_bytes / iterations);
+                fflush(stdout);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "Datasets.h"
+#include "Defines.h"
+#include "Models/AffineNet.h"
+#include "Utils/Hogwild.h"
+
+using namespace StaticNet;
+
+// ----------------------------------------------------------------------------
+// Convergence vs. throughput of Hogwild against the synchronous path.
+//
+// Both train a fresh AffineNet for the same number of epochs over the same
+// batches: the synchronous run steps in order with OpenMP-parallel kernels,
+// the Hogwild run uses one single-threaded worker per thread. Reports
+// samples/s together with held-out loss and accuracy. Uses MNIST when given
+// `--mnist <dir>`, otherwise separable synthetic data of the same shape.
+// ----------------------------------------------------------------------------
+
+constexpr size_t Batch = 32;
+constexpr size_t Input = 784;
+constexpr size_t Classes = 10;
+constexpr size_t SyntheticBatches = 256;
+
+using Images = std::vector<Tensor<float, Batch, Input>>;
+using Labels = std::vector<Tensor<bool, Batch, Classes>>;
+
+void synthetic(Images &images, Labels &labels)
+{
+    Tensor<float, Classes, Input> prototypes;
+    for (size_t c = 0; c < Classes; c++)
+        for (size_t i = 0; i < Input; i++)
+            prototypes[c][i] = Random::rand<double>() < 0.2 ? 1.0f : 0.0f;
+
+    for (size_t n = 0; n < SyntheticBatches; n++)
+    {
+        Tensor<float, Batch, Input> image;
+        Tensor<bool, Batch, Classes> label(false);
+        for (size_t b = 0; b < Batch; b++)
+        {
+            size_t c = (size_t)(Random::rand<double>() * Classes) % Classes;
+            label[b][c] = true;
+            for (size_t i = 0; i < Input; i++)
+                image[b][i] = prototypes[c][i] * (float)Random::rand<double>();
+        }
+        images.push_back(image);
+        labels.push_back(label);
+    }
+}
+
+void evaluate(AffineNet &model, const Images &images, const Labels &labels, size_t first, float &loss, float &accuracy)
+{
+    size_t correct = 0;
+    loss = 0.0f;
+    for (size_t n = first; n < images.size(); n++)
+    {
+        auto result = softmax(model.forward(images[n]));
+        for (size_t b = 0; b < Batch; b++)
+        {
+            loss += Defines::CrossEntropy<Classes>(labels[n][b], result[b]);
+            correct += argmax(result[b]) == argmax(labels[n][b]);
+        }
+    }
+
+    const size_t samples = (images.size() - first) * Batch;
+    loss /= samples;
+    accuracy = (float)correct / samples;
+}
+
+void train(const char *name, bool hogwild, int threads, size_t epochs, const Images &images, const Labels &labels)
+{
+    const size_t train_batches = images.size() * 9 / 10;
+    AffineNet model;
+
+#ifdef _OPENMP
+    omp_set_num_threads(hogwild ? 1 : threads);
+#endif
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t epoch = 0; epoch < epochs; epoch++)
+        train_hogwild(model, hogwild ? threads : 1, train_batches, [&](size_t n) {
+            auto result = softmax(model.forward(images[n]));
+            model.backward(result - labels[n], 0.05f);
+        });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+    float loss, accuracy;
+    evaluate(model, images, labels, train_batches, loss, accuracy);
+
+    printf("{\"suite\": \"hogwild\", \"name\": \"%s\", \"shape\": \"%zux%zu\", \"threads\": %d, "
+           "\"epochs\": %zu, \"seconds\": %.3f, \"samples_per_sec\": %.1f, \"loss\": %.4f, \"accuracy\": %.4f}\n",
+           name, Batch, Input, threads, epochs, seconds, epochs * train_batches * Batch / seconds, loss, accuracy);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    Bench::parse_args(argc, argv);
+
+    std::string mnist;
+    size_t epochs = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--mnist") && i + 1 < argc)
+            mnist = argv[++i];
+        else if (!strcmp(argv[i], "--epochs") && i + 1 < argc)
+            epochs = strtoul(argv[++i], nullptr, 10);
+    }
+
+    Images images;
+    Labels labels;
+    if (mnist.empty())
+        synthetic(images, labels);
+    else
+    {
+        images = Image<Batch, Input>(mnist + "/train-images.idx3-ubyte");
+        labels = Label<Batch, Classes>(mnist + "/train-labels.idx1-ubyte");
+    }
+
+    const std::string &filter = Bench::options().filter;
+    for (int threads : Bench::options().threads)
+    {
+        if (filter.empty() || std::string("affinenet_sync").find(filter) != std::string::npos)
+            train("affinenet_sync", false, threads, epochs, images, labels);
+        if (filter.empty() || std::string("affinenet_hogwild").find(filter) != std::string::npos)
+            train("affinenet_hogwild", true, threads, epochs, images, labels);
+    }
+}
@@ -0,0 +1,163 @@
+#include <string>
+
+#include "Bench.h"
+#include "Defines.h"
+#include "Modules/AvgPool2D.h"
+#include "Modules/Conv2D.h"
+#include "Modules/DepthwiseConv2D.h"
+#include "Modules/MaxPool2D.h"
+
+using namespace StaticNet;
+
+template <size_t M, size_t K, size_t N>
+void bench_dot()
+{
+    auto a = Tensor<float, M, K>::random();
+    auto b = Tensor<float, K, N>::random();
+
+    Bench::run("kernels", "dot", std::to_string(M) + "x" + std::to_string(K) + "x" + std::to_string(N),
+               2.0 * M * N * K, sizeof(float) * (M * K + K * N + M * N),
+               [&]() { auto c = dot(a, b); });
+}
+
+template <size_t Batch, size_t C, size_t IDim, size_t K>
+void bench_im2col()
+{
+    constexpr size_t ODim = IDim - K + 1;
+    constexpr size_t InputSize = Batch * C * IDim * IDim;
+    constexpr size_t ColSize = Batch * ODim * ODim * C * K * K;
+    std::string shape = std::to_string(Batch) + "x" + std::to_string(C) + "x" + std::to_string(IDim) + "x" +
+                        std::to_string(IDim) + " k" + std::to_string(K);
+
+    auto input = Tensor<float, Batch, C, IDim, IDim>::random();
+    Bench::run("kernels", "im2col", shape, 0.0, sizeof(float) * (InputSize + ColSize),
+               [&]() { auto col = im2col<K>(input); });
+
+    auto col = Tensor<float, Batch * ODim * ODim, C * K * K>::random();
+    Bench::run("kernels", "col2im", shape, (double)ColSize, sizeof(float) * (InputSize + ColSize),
+               [&]() { auto image = col2im<float, K, Batch, C, IDim>(col); });
+}
+
+// 3x3 "same" convolution, dense vs depthwise over the same shape.
+template <size_t Batch, size_t C, size_t Dim>
+void bench_conv()
+{
+    using Window = Window2D<3, 3, 1, 1, 1, 1>;
+    using Dense = Conv2D<Tensor<float, C, Dim, Dim>, Tensor<float, C, Dim, Dim>, Window>;
+    using Depthwise = DepthwiseConv2D<Tensor<float, C, Dim, Dim>, Tensor<float, C, Dim, Dim>, Window>;
+    constexpr size_t Size = Batch * C * Dim * Dim;
+    std::string shape = std::to_string(Batch) + "x" + std::to_string(C) + "x" + std::to_string(Dim) + "x" +
+                        std::to_string(Dim) + " k3";
+
+    Module<float> root("Bench");
+    Dense dense(&root);
+    Depthwise depthwise(&root);
+
+    auto input = Tensor<float, Batch, C, Dim, Dim>::random();
+    Bench::run("kernels", "conv2d", shape, (double)Dense::template cost<Batch>().forward_flops, sizeof(float) * 2 * Size,
+               [&]() { auto output = dense.forward(input); });
+    Bench::run("kernels", "depthwise_conv2d", shape, (double)Depthwise::template cost<Batch>().forward_flops, sizeof(float) * 2 * Size,
+               [&]() { auto output = depthwise.forward(input); });
+
+    auto delta = Tensor<float, Batch, C, Dim, Dim>::random();
+    Bench::run("kernels", "depthwise_conv2d_backward", shape, (double)Depthwise::template cost<Batch>().backward_flops, sizeof(float) * 3 * Size,
+               [&]() { auto output = depthwise.backward(delta, 0.0f); });
+}
+
+template <size_t Batch, size_t C, size_t IDim, size_t ODim>
+void bench_pool()
+{
+    constexpr size_t InputSize = Batch * C * IDim * IDim;
+    constexpr size_t OutputSize = Batch * C * ODim * ODim;
+    std::string shape = std::to_string(Batch) + "x" + std::to_string(C) + "x" + std::to_string(IDim) + "x" +
+                        std::to_string(IDim) + "->" + std::to_string(ODim) + "x" + std::to_string(ODim);
+
+    Module<float> root("Bench");
+    AvgPool2D<Tensor<float, C, IDim, IDim>, Tensor<float, C, ODim, ODim>> avgpool(&root);
+
+    auto input = Tensor<float, Batch, C, IDim, IDim>::random();
+    Bench::run("kernels", "pool", shape, (double)InputSize, sizeof(float) * (InputSize + OutputSize),
+               [&]() { auto output = avgpool.forward(input); });
+
+    auto delta = Tensor<float, Batch, C, ODim, ODim>::random();
+    Bench::run("kernels", "unpool", shape, (double)InputSize, sizeof(float) * (InputSize + OutputSize),
+               [&]() { auto output = avgpool.backward(delta, 0.0f); });
+
+    MaxPool2D<Tensor<float, C, IDim, IDim>, Tensor<float, C, ODim, ODim>> maxpool(&root);
+    Bench::run("kernels", "max_pool", shape, (double)InputSize, sizeof(float) * (InputSize + 2 * OutputSize),
+               [&]() { auto output = maxpool.forward(input); });
+    Bench::run("kernels", "max_unpool", shape, (double)OutputSize, sizeof(float) * (InputSize + 2 * OutputSize),
+               [&]() { auto output = maxpool.backward(delta, 0.0f); });
+}
+
+template <size_t Batch, size_t Classes>
+void bench_softmax_cross_entropy()
+{
+    auto logits = Tensor<float, Batch, Classes>::random();
+    Tensor<bool, Batch, Classes> labels(false);
+    for (size_t i = 0; i < Batch; i++)
+        labels[i][i % Classes] = true;
+
+    Bench::run("kernels", "softmax_cross_entropy", std::to_string(Batch) + "x" + std::to_string(Classes),
+               6.0 * Batch * Classes, sizeof(float) * 3 * Batch * Classes,
+               [&]() {
+                   auto result = softmax(logits);
+                   float loss = 0.0f;
+                   for (size_t i = 0; i < Batch; i++)
+                       loss += Defines::CrossEntropy<Classes>(labels[i], result[i]) / (float)Batch;
+                   auto delta = result - labels;
+               });
+}
+
+int main(int argc, char *argv[])
+{
+    Bench::parse_args(argc, argv);
+
+    bench_dot<200, 784, 300>();
+    bench_dot<200, 300, 200>();
+    bench_dot<200, 192, 10>();
+    bench_dot<115200, 25, 4>();
+    bench_dot<12800, 100, 12>();
+
+    {
+        auto x = Tensor<float, 200, 4, 24, 24>::random();
+        Bench::run("kernels", "transpose", "200x4x24x24 <1,2,3,0>", 0.0, sizeof(float) * 2 * 200 * 4 * 24 * 24,
+                   [&]() { auto y = x.transpose<1, 2, 3, 0>(); });
+    }
+    {
+        auto x = Tensor<float, 200, 1, 5, 5, 24, 24>::random();
+        Bench::run("kernels", "transpose", "200x1x5x5x24x24 <0,4,5,1,2,3>", 0.0, sizeof(float) * 2 * 200 * 25 * 24 * 24,
+                   [&]() { auto y = x.transpose<0, 4, 5, 1, 2, 3>(); });
+    }
+
+    bench_im2col<200, 1, 28, 5>();
+    bench_im2col<200, 4, 12, 5>();
+
+    {
+        constexpr size_t Size = 200 * 784;
+        auto a = Tensor<float, 200, 784>::random();
+        auto b = Tensor<float, 200, 784>::random();
+        Bench::run("kernels", "hadamard", "200x784", (double)Size, sizeof(float) * 3 * Size,
+                   [&]() { auto c = hadamard(a, b); });
+        Bench::run("kernels", "map", "200x784 relu", (double)Size, sizeof(float) * 2 * Size,
+                   [&]() { auto c = a.map(Defines::ReLU); });
+    }
+
+    {
+        constexpr size_t Size = 200 * 4 * 24 * 24;
+        auto x = Tensor<float, 200, 4, 24, 24>::random();
+        Tensor<float, 4, 24, 24> batch_sum;
+        Tensor<float, 4> channel_sum;
+        Bench::run("kernels", "reduce", "200x4x24x24 axis 0", (double)Size, sizeof(float) * Size,
+                   [&]() { reduce_sum<0>(x, batch_sum); });
+        Bench::run("kernels", "reduce", "200x4x24x24 except 1", (double)Size, sizeof(float) * Size,
+                   [&]() { reduce_sum_except<1>(x, channel_sum); });
+    }
+
+    bench_pool<200, 4, 24, 12>();
+    bench_pool<200, 12, 8, 4>();
+
+    bench_conv<32, 32, 16>();
+
+    bench_softmax_cross_entropy<200, 10>();
+}
@@ -0,0 +1,55 @@
+#include <string>
+
+#include "Bench.h"
+#include "Defines.h"
+#include "Models/LeNet.h"
+#include "Models/AffineNet.h"
+
+using namespace StaticNet;
+
+constexpr size_t Batch = 200;
+constexpr size_t Classes = 10;
+
+template <class Model, size_t... InputDims>
+void bench_model(const char *name)
+{
+    constexpr ModuleCost cost = Model::template cost<Batch>();
+    constexpr double forward_flops = cost.forward_flops;
+    constexpr double backward_flops = cost.backward_flops;
+    constexpr double bytes = cost.parameter_bytes + cost.peak_bytes;
+
+    Model model;
+    auto input = Tensor<float, Batch, InputDims...>::random();
+    Tensor<bool, Batch, Classes> labels(false);
+    for (size_t i = 0; i < Batch; i++)
+        labels[i][i % Classes] = true;
+
+    std::string shape = std::to_string(Batch);
+    for (size_t dim : {InputDims...})
+        shape += "x" + std::to_string(dim);
+
+    Bench::run("models", (std::string(name) + "_forward").c_str(), shape, forward_flops, bytes,
+               [&]() { auto output = model.forward(input); });
+
+    auto output = model.forward(input);
+    auto delta = (softmax(output) - labels) * 0.0f;
+    Bench::run("models", (std::string(name) + "_backward").c_str(), shape, backward_flops, bytes,
+               [&]() { auto dx = model.backward(delta, 0.0f); });
+
+    Bench::run("models", (std::string(name) + "_step").c_str(), shape, forward_flops + backward_flops, 2 * bytes,
+               [&]() {
+                   auto result = softmax(model.forward(input));
+                   float loss = 0.0f;
+                   for (size_t i = 0; i < Batch; i++)
+                       loss += Defines::CrossEntropy<Classes>(labels[i], result[i]) / (float)Batch;
+                   model.backward(result - labels, 0.01f);
+               });
+}
+
+int main(int argc, char *argv[])
+{
+    Bench::parse_args(argc, argv);
+
+    bench_model<LeNet, 1, 28, 28>("lenet");
+    bench_model<AffineNet, 784>("affinenet");
+}
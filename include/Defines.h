@@ -45,16 +45,7 @@ namespace StaticNet
         template <size_t Input>
         std::function<Tensor<float, Input>(Tensor<float, Input>)> Softmax = [](Tensor<float, Input> x)
         {
-            float max = x[argmax(x)];
-            float sum = 0.0f;
-
-            for (size_t i = 0; i < Input; i++)
-            {
-                x[i] = std::exp(x[i] - max);
-                sum += x[i];
-            }
-
-            return x / sum;
+            return softmax(x);
         };
 
         // ------------------------------------------------------------
@@ -0,0 +1,243 @@
+#ifndef KERNELS_BATCHNORM_H_
+#define KERNELS_BATCHNORM_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Per-channel batch normalization over a channel-blocked
+        // activation [batch, channels / block, pixels, block] (block 1 is
+        // NCHW, block == channels is NHWC or a plain [batch, features]).
+        //
+        // Work is split into tiles of up to NormLanes channels of one
+        // block, so every layout is parallel over channels and the inner
+        // loops run along the contiguous lanes (or pixels for block 1).
+        // Statistics are single-pass: each batch item's [pixels, lanes]
+        // chunk is reduced while it is in cache and merged into the
+        // running mean / M2 with Chan's update of Welford's algorithm.
+        // ------------------------------------------------------------
+
+        constexpr size_t NormLanes = 16;
+
+        struct NormTile
+        {
+            size_t group, lane, lanes;
+        };
+
+        inline size_t norm_tiles(size_t channels, size_t block)
+        {
+            return channels / block * ((block + NormLanes - 1) / NormLanes);
+        }
+
+        inline NormTile norm_tile(size_t t, size_t block)
+        {
+            const size_t per_group = (block + NormLanes - 1) / NormLanes;
+            const size_t lane = t % per_group * NormLanes;
+            return {t / per_group, lane, std::min(NormLanes, block - lane)};
+        }
+
+        // mean[c] and biased var[c] over batch and pixels.
+        template <class T>
+        void batchnorm_statistics(const T *x, T *mean, T *var, size_t batch, size_t channels, size_t pixels, size_t block)
+        {
+            const size_t groups = channels / block, tiles = norm_tiles(channels, block);
+
+#pragma omp parallel for if (batch * channels * pixels >= ParallelThreshold)
+            for (long t = 0; t < (long)tiles; t++)
+            {
+                const NormTile tile = norm_tile(t, block);
+                T m[NormLanes] = {}, m2[NormLanes] = {};
+                size_t n = 0;
+
+                for (size_t b = 0; b < batch; b++)
+                {
+                    const T *chunk = x + (b * groups + tile.group) * pixels * block + tile.lane;
+                    T sum[NormLanes] = {}, sq[NormLanes] = {};
+
+                    if (tile.lanes == 1)
+                    {
+                        T s = T();
+#pragma omp simd reduction(+ : s)
+                        for (size_t p = 0; p < pixels; p++)
+                            s += chunk[p * block];
+                        sum[0] = s;
+                    }
+                    else
+                        for (size_t p = 0; p < pixels; p++)
+                        {
+                            const T *row = chunk + p * block;
+#pragma omp simd
+                            for (size_t l = 0; l < tile.lanes; l++)
+                                sum[l] += row[l];
+                        }
+
+                    for (size_t l = 0; l < tile.lanes; l++)
+                        sum[l] /= (T)pixels;
+
+                    if (tile.lanes == 1)
+                    {
+                        const T mu = sum[0];
+                        T s = T();
+#pragma omp simd reduction(+ : s)
+                        for (size_t p = 0; p < pixels; p++)
+                            s += (chunk[p * block] - mu) * (chunk[p * block] - mu);
+                        sq[0] = s;
+                    }
+                    else
+                        for (size_t p = 0; p < pixels; p++)
+                        {
+                            const T *row = chunk + p * block;
+#pragma omp simd
+                            for (size_t l = 0; l < tile.lanes; l++)
+                                sq[l] += (row[l] - sum[l]) * (row[l] - sum[l]);
+                        }
+
+                    const size_t total = n + pixels;
+                    const T weight = (T)pixels / (T)total, cross = (T)n * (T)pixels / (T)total;
+                    for (size_t l = 0; l < tile.lanes; l++)
+                    {
+                        const T delta = sum[l] - m[l];
+                        m[l] += delta * weight;
+                        m2[l] += sq[l] + delta * delta * cross;
+                    }
+                    n = total;
+                }
+
+                const size_t c0 = tile.group * block + tile.lane;
+                for (size_t l = 0; l < tile.lanes; l++)
+                {
+                    mean[c0 + l] = m[l];
+                    var[c0 + l] = m2[l] / (T)n;
+                }
+            }
+        }
+
+        // y = x * scale[c] + shift[c]; y may alias x.
+        template <class T>
+        void batchnorm_apply(const T *x, T *y, const T *scale, const T *shift, size_t batch, size_t channels, size_t pixels, size_t block)
+        {
+            const size_t groups = channels / block;
+
+            if (block == 1)
+            {
+#pragma omp parallel for if (batch * channels * pixels >= ParallelThreshold)
+                for (long r = 0; r < (long)(batch * channels); r++)
+                {
+                    const T a = scale[r % channels], b = shift[r % channels];
+                    const T *src = x + r * pixels;
+                    T *dst = y + r * pixels;
+#pragma omp simd
+                    for (size_t p = 0; p < pixels; p++)
+                        dst[p] = src[p] * a + b;
+                }
+            }
+            else
+            {
+#pragma omp parallel for if (batch * channels * pixels >= ParallelThreshold)
+                for (long r = 0; r < (long)(batch * groups * pixels); r++)
+                {
+                    const size_t c0 = r / pixels % groups * block;
+                    const T *a = scale + c0, *b = shift + c0;
+                    const T *src = x + r * block;
+                    T *dst = y + r * block;
+#pragma omp simd
+                    for (size_t l = 0; l < block; l++)
+                        dst[l] = src[l] * a[l] + b[l];
+                }
+            }
+        }
+
+        // Backward of y = gamma * (x - mean) * inv_std + beta with batch
+        // statistics: fills dx, and dgamma / dbeta summed over the batch.
+        template <class T>
+        void batchnorm_backward(const T *x, const T *dy, const T *mean, const T *inv_std, const T *gamma,
+                                T *dx, T *dgamma, T *dbeta, size_t batch, size_t channels, size_t pixels, size_t block)
+        {
+            const size_t groups = channels / block, tiles = norm_tiles(channels, block);
+            const T count = (T)(batch * pixels);
+
+#pragma omp parallel for if (batch * channels * pixels >= ParallelThreshold)
+            for (long t = 0; t < (long)tiles; t++)
+            {
+                const NormTile tile = norm_tile(t, block);
+                const size_t c0 = tile.group * block + tile.lane;
+                T sum_dy[NormLanes] = {}, sum_dyx[NormLanes] = {};
+
+                for (size_t b = 0; b < batch; b++)
+                {
+                    const size_t offset = (b * groups + tile.group) * pixels * block + tile.lane;
+                    if (tile.lanes == 1)
+                    {
+                        const T *xs = x + offset, *gs = dy + offset;
+                        const T mu = mean[c0];
+                        T s = T(), sx = T();
+#pragma omp simd reduction(+ : s, sx)
+                        for (size_t p = 0; p < pixels; p++)
+                        {
+                            s += gs[p * block];
+                            sx += gs[p * block] * (xs[p * block] - mu);
+                        }
+                        sum_dy[0] += s;
+                        sum_dyx[0] += sx;
+                        continue;
+                    }
+
+                    for (size_t p = 0; p < pixels; p++)
+                    {
+                        const T *xs = x + offset + p * block, *gs = dy + offset + p * block;
+#pragma omp simd
+                        for (size_t l = 0; l < tile.lanes; l++)
+                        {
+                            sum_dy[l] += gs[l];
+                            sum_dyx[l] += gs[l] * (xs[l] - mean[c0 + l]);
+                        }
+                    }
+                }
+
+                // dx = k dy + u x + v per channel.
+                T k[NormLanes], u[NormLanes], v[NormLanes];
+                for (size_t l = 0; l < tile.lanes; l++)
+                {
+                    const T s = inv_std[c0 + l];
+                    dbeta[c0 + l] = sum_dy[l];
+                    dgamma[c0 + l] = sum_dyx[l] * s;
+                    k[l] = gamma[c0 + l] * s;
+                    u[l] = -k[l] * s * s * sum_dyx[l] / count;
+                    v[l] = -k[l] * sum_dy[l] / count - u[l] * mean[c0 + l];
+                }
+
+                for (size_t b = 0; b < batch; b++)
+                {
+                    const size_t offset = (b * groups + tile.group) * pixels * block + tile.lane;
+                    if (tile.lanes == 1)
+                    {
+                        const T *xs = x + offset, *gs = dy + offset;
+                        T *out = dx + offset;
+#pragma omp simd
+                        for (size_t p = 0; p < pixels; p++)
+                            out[p * block] = k[0] * gs[p * block] + u[0] * xs[p * block] + v[0];
+                        continue;
+                    }
+
+                    for (size_t p = 0; p < pixels; p++)
+                    {
+                        const T *xs = x + offset + p * block, *gs = dy + offset + p * block;
+                        T *out = dx + offset + p * block;
+#pragma omp simd
+                        for (size_t l = 0; l < tile.lanes; l++)
+                            out[l] = k[l] * gs[l] + u[l] * xs[l] + v[l];
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef KERNELS_BROADCAST_H_
+#define KERNELS_BROADCAST_H_
+
+#include <cstddef>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Elementwise out = op(a, b) over a dense output of `rank` dims,
+        // with a and b read through per-dim element strides (0 where an
+        // operand is broadcast). Adjacent dims that both operands walk
+        // the same way are merged first, so a bias over [batch, C, H, W]
+        // becomes rows of H * W with a constant right-hand side and any
+        // same-shape operand one flat row. The innermost merged dim runs
+        // under `omp simd`, rows are split across threads. out may alias a.
+        // ------------------------------------------------------------
+
+        constexpr size_t BroadcastMaxRank = 16;
+
+        template <class A, class B, class C, class Op>
+        void broadcast(const A *a, const size_t *a_strides, const B *b, const size_t *b_strides,
+                       C *out, const size_t *dims, size_t rank, Op op)
+        {
+            // Merged dims, innermost first.
+            size_t extent[BroadcastMaxRank], sa[BroadcastMaxRank], sb[BroadcastMaxRank];
+            size_t merged = 0, total = 1;
+            for (size_t i = rank; i-- > 0;)
+            {
+                total *= dims[i];
+                if (dims[i] == 1)
+                    continue;
+                if (merged && a_strides[i] == sa[merged - 1] * extent[merged - 1] &&
+                    b_strides[i] == sb[merged - 1] * extent[merged - 1])
+                {
+                    extent[merged - 1] *= dims[i];
+                    continue;
+                }
+                extent[merged] = dims[i];
+                sa[merged] = a_strides[i];
+                sb[merged] = b_strides[i];
+                merged++;
+            }
+
+            if (merged == 0)
+            {
+                out[0] = op(a[0], b[0]);
+                return;
+            }
+
+            const size_t inner = extent[0], ia = sa[0], ib = sb[0];
+            const size_t rows = total / inner;
+
+#pragma omp parallel for if (total >= ParallelThreshold)
+            for (long r = 0; r < (long)rows; r++)
+            {
+                size_t oa = 0, ob = 0, rest = r;
+                for (size_t k = 1; k < merged; k++)
+                {
+                    const size_t index = rest % extent[k];
+                    rest /= extent[k];
+                    oa += index * sa[k];
+                    ob += index * sb[k];
+                }
+
+                const A *pa = a + oa;
+                const B *pb = b + ob;
+                C *dst = out + r * inner;
+
+                if (ia == 1 && ib == 1)
+                {
+#pragma omp simd
+                    for (size_t i = 0; i < inner; i++)
+                        dst[i] = op(pa[i], pb[i]);
+                }
+                else if (ia == 1 && ib == 0)
+                {
+                    const B value = *pb;
+#pragma omp simd
+                    for (size_t i = 0; i < inner; i++)
+                        dst[i] = op(pa[i], value);
+                }
+                else if (ia == 0 && ib == 1)
+                {
+                    const A value = *pa;
+#pragma omp simd
+                    for (size_t i = 0; i < inner; i++)
+                        dst[i] = op(value, pb[i]);
+                }
+                else
+                {
+                    for (size_t i = 0; i < inner; i++)
+                        dst[i] = op(pa[i * ia], pb[i * ib]);
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef KERNELS_DEPTHWISE_CONV_H_
+#define KERNELS_DEPTHWISE_CONV_H_
+
+#include <cstddef>
+
+#include "Kernels/Im2Col.h"
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Direct per-channel convolution over NCHW planes.
+        //
+        // Output channel f = c * multiplier + m filters input channel c
+        // with its own KH x KW taps ([C * multiplier, KH, KW] weights).
+        // Each tap is applied to a whole output row at once, over the
+        // range of columns whose input falls inside the image, so padding
+        // costs nothing and the inner loop is a unit- or constant-stride
+        // multiply-add.
+        // ------------------------------------------------------------
+
+        // Output columns [lo, hi) whose tap at input column ox * stride + offset is in range.
+        inline void tap_range(long offset, size_t stride, size_t iw, size_t ow, size_t &lo, size_t &hi)
+        {
+            lo = offset >= 0 ? 0 : (size_t)((-offset + (long)stride - 1) / (long)stride);
+            hi = offset >= (long)iw ? 0 : (size_t)(((long)iw - 1 - offset) / (long)stride + 1);
+            hi = hi < ow ? hi : ow;
+            lo = lo < hi ? lo : hi;
+        }
+
+        template <class T>
+        void depthwise_conv2d(const T *in, const T *weights, const T *bias, T *out,
+                              size_t batch, size_t multiplier, const Conv2DGeometry &g)
+        {
+            const size_t oh = g.oh(), ow = g.ow();
+            const size_t filters = g.channels * multiplier, taps = g.kh * g.kw;
+
+#pragma omp parallel for if (batch * filters * oh * ow * taps >= ParallelThreshold)
+            for (long p = 0; p < (long)(batch * filters); p++)
+            {
+                const size_t b = p / filters, f = p % filters;
+                const T *src = in + (b * g.channels + f / multiplier) * g.ih * g.iw;
+                const T *filter = weights + f * taps;
+                T *dst = out + p * oh * ow;
+
+                for (size_t oy = 0; oy < oh; oy++)
+                {
+                    T *row = dst + oy * ow;
+                    for (size_t ox = 0; ox < ow; ox++)
+                        row[ox] = bias[f];
+
+                    for (size_t ky = 0; ky < g.kh; ky++)
+                    {
+                        const long y = (long)(oy * g.sh + ky * g.dh) - (long)g.ph;
+                        if (y < 0 || y >= (long)g.ih)
+                            continue;
+
+                        const T *line = src + y * g.iw;
+                        for (size_t kx = 0; kx < g.kw; kx++)
+                        {
+                            const long offset = (long)(kx * g.dw) - (long)g.pw;
+                            const T w = filter[ky * g.kw + kx];
+                            size_t lo, hi;
+                            tap_range(offset, g.sw, g.iw, ow, lo, hi);
+#pragma omp simd
+                            for (size_t ox = lo; ox < hi; ox++)
+                                row[ox] += w * line[ox * g.sw + offset];
+                        }
+                    }
+                }
+            }
+        }
+
+        // din = sum over taps of w * dout, scattered back along rows. Each
+        // thread owns one input plane and all the filters reading it.
+        template <class T>
+        void depthwise_conv2d_backward_data(const T *dout, const T *weights, T *din,
+                                            size_t batch, size_t multiplier, const Conv2DGeometry &g)
+        {
+            const size_t oh = g.oh(), ow = g.ow();
+            const size_t filters = g.channels * multiplier, taps = g.kh * g.kw;
+
+#pragma omp parallel for if (batch * filters * oh * ow * taps >= ParallelThreshold)
+            for (long p = 0; p < (long)(batch * g.channels); p++)
+            {
+                const size_t b = p / g.channels, c = p % g.channels;
+                T *dst = din + p * g.ih * g.iw;
+                for (size_t i = 0; i < g.ih * g.iw; i++)
+                    dst[i] = T();
+
+                for (size_t m = 0; m < multiplier; m++)
+                {
+                    const size_t f = c * multiplier + m;
+                    const T *src = dout + (b * filters + f) * oh * ow;
+                    const T *filter = weights + f * taps;
+
+                    for (size_t oy = 0; oy < oh; oy++)
+                    {
+                        const T *row = src + oy * ow;
+                        for (size_t ky = 0; ky < g.kh; ky++)
+                        {
+                            const long y = (long)(oy * g.sh + ky * g.dh) - (long)g.ph;
+                            if (y < 0 || y >= (long)g.ih)
+                                continue;
+
+                            T *line = dst + y * g.iw;
+                            for (size_t kx = 0; kx < g.kw; kx++)
+                            {
+                                const long offset = (long)(kx * g.dw) - (long)g.pw;
+                                const T w = filter[ky * g.kw + kx];
+                                size_t lo, hi;
+                                tap_range(offset, g.sw, g.iw, ow, lo, hi);
+#pragma omp simd
+                                for (size_t ox = lo; ox < hi; ox++)
+                                    line[ox * g.sw + offset] += w * row[ox];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // dweights and dbias summed over the batch; threads split filters.
+        template <class T>
+        void depthwise_conv2d_backward_weights(const T *in, const T *dout, T *dweights, T *dbias,
+                                               size_t batch, size_t multiplier, const Conv2DGeometry &g)
+        {
+            const size_t oh = g.oh(), ow = g.ow();
+            const size_t filters = g.channels * multiplier, taps = g.kh * g.kw;
+
+#pragma omp parallel for if (batch * filters * oh * ow * taps >= ParallelThreshold)
+            for (long f = 0; f < (long)filters; f++)
+            {
+                T *grad = dweights + f * taps;
+                for (size_t t = 0; t < taps; t++)
+                    grad[t] = T();
+                dbias[f] = T();
+
+                for (size_t b = 0; b < batch; b++)
+                {
+                    const T *src = in + (b * g.channels + f / multiplier) * g.ih * g.iw;
+                    const T *plane = dout + (b * filters + f) * oh * ow;
+                    dbias[f] += pairwise_sum(plane, oh * ow);
+
+                    for (size_t oy = 0; oy < oh; oy++)
+                    {
+                        const T *row = plane + oy * ow;
+                        for (size_t ky = 0; ky < g.kh; ky++)
+                        {
+                            const long y = (long)(oy * g.sh + ky * g.dh) - (long)g.ph;
+                            if (y < 0 || y >= (long)g.ih)
+                                continue;
+
+                            const T *line = src + y * g.iw;
+                            for (size_t kx = 0; kx < g.kw; kx++)
+                            {
+                                const long offset = (long)(kx * g.dw) - (long)g.pw;
+                                size_t lo, hi;
+                                tap_range(offset, g.sw, g.iw, ow, lo, hi);
+                                T sum = T();
+#pragma omp simd reduction(+ : sum)
+                                for (size_t ox = lo; ox < hi; ox++)
+                                    sum += row[ox] * line[ox * g.sw + offset];
+                                grad[ky * g.kw + kx] += sum;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
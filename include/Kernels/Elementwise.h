@@ -0,0 +1,107 @@
+#ifndef KERNELS_ELEMENTWISE_H_
+#define KERNELS_ELEMENTWISE_H_
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Flat elementwise loops behind the Tensor operators. They see only
+        // pointers and an element count, so every tensor shape shares one
+        // copy of each loop; src and dst may be the same buffer.
+        // ------------------------------------------------------------
+
+        template <class T, class U>
+        void copy(const U *src, T *dst, size_t n)
+        {
+#pragma omp parallel for simd if (n >= ParallelThreshold)
+            for (long i = 0; i < (long)n; i++)
+                dst[i] = src[i];
+        }
+
+        template <class T, class U>
+        void scale(const T *src, T *dst, size_t n, U s)
+        {
+#pragma omp parallel for simd if (n >= ParallelThreshold)
+            for (long i = 0; i < (long)n; i++)
+                dst[i] = src[i] * s;
+        }
+
+        template <class T, class U>
+        void divide(const T *src, T *dst, size_t n, U s)
+        {
+#pragma omp parallel for simd if (n >= ParallelThreshold)
+            for (long i = 0; i < (long)n; i++)
+                dst[i] = src[i] / s;
+        }
+
+        template <class T>
+        void negate(const T *src, T *dst, size_t n)
+        {
+#pragma omp parallel for simd if (n >= ParallelThreshold)
+            for (long i = 0; i < (long)n; i++)
+                dst[i] = -src[i];
+        }
+
+        template <class T>
+        void multiply(const T *a, const T *b, T *out, size_t n)
+        {
+#pragma omp parallel for simd if (n >= ParallelThreshold)
+            for (long i = 0; i < (long)n; i++)
+                out[i] = a[i] * b[i];
+        }
+
+        template <class T, class U>
+        bool equal(const T *a, const U *b, size_t n)
+        {
+            for (size_t i = 0; i < n; i++)
+                if (a[i] != b[i])
+                    return false;
+            return true;
+        }
+
+        // Serial and in order: f is user code and need not be thread-safe.
+        template <class T, class Other>
+        void map(const T *src, Other *dst, size_t n, const std::function<Other(T)> &f)
+        {
+            for (size_t i = 0; i < n; i++)
+                dst[i] = f(src[i]);
+        }
+
+        // Softmax of each row of a [rows, n] block.
+        template <class T>
+        void softmax(const T *src, T *dst, size_t rows, size_t n)
+        {
+#pragma omp parallel for if (rows * n >= ParallelThreshold)
+            for (long r = 0; r < (long)rows; r++)
+            {
+                const T *in = src + r * n;
+                T *out = dst + r * n;
+
+                T top = in[0];
+                for (size_t i = 1; i < n; i++)
+                    top = in[i] > top ? in[i] : top;
+
+                T sum = T();
+                for (size_t i = 0; i < n; i++)
+                {
+                    out[i] = std::exp(in[i] - top);
+                    sum += out[i];
+                }
+
+                const T inv = T(1) / sum;
+#pragma omp simd
+                for (size_t i = 0; i < n; i++)
+                    out[i] *= inv;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef KERNELS_GEMM_H_
+#define KERNELS_GEMM_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Row-major GEMM: C = alpha * op(A) op(B) + beta * C.
+        //
+        //   gemm     A [M, K],  B [K, N]
+        //   gemm_tn  A [K, M],  B [K, N]   (A^T B, e.g. weight gradients)
+        //   gemm_nt  A [M, K],  B [N, K]   (A B^T, e.g. input gradients)
+        //
+        // Transposed operands are read in place. Tiles of rows of C are
+        // split across threads; K and N are tiled so a panel of B stays in
+        // cache while the inner loop runs along a contiguous row.
+        // ------------------------------------------------------------
+
+        constexpr size_t GemmRows = 32;
+        constexpr size_t GemmDepth = 128;
+        constexpr size_t GemmCols = 512;
+
+        template <class T>
+        void scale_rows(T *c, size_t rows, size_t n, T beta)
+        {
+            if (beta == T())
+                std::fill(c, c + rows * n, T());
+            else if (beta != T(1))
+                for (size_t i = 0; i < rows * n; i++)
+                    c[i] *= beta;
+        }
+
+        // Runs block(b, i0, i1) over every GemmRows tile of rows of the
+        // `batch` outputs as one flat loop: many small products spread
+        // across the batch, a few large ones across their tiles. Below
+        // ParallelThreshold multiply-adds no OpenMP region is entered.
+        template <class Block>
+        void for_each_gemm_tile(size_t batch, size_t m, size_t k, size_t n, Block block)
+        {
+            const size_t tiles = (m + GemmRows - 1) / GemmRows;
+            auto run = [&](size_t t) {
+                const size_t b = t / tiles, i0 = t % tiles * GemmRows;
+                block(b, i0, std::min(m, i0 + GemmRows));
+            };
+
+            if (batch * m * k * n < ParallelThreshold)
+            {
+                for (size_t t = 0; t < batch * tiles; t++)
+                    run(t);
+                return;
+            }
+
+#pragma omp parallel for
+            for (long t = 0; t < (long)(batch * tiles); t++)
+                run(t);
+        }
+
+        // ------------------------------------------------------------
+        // Batched forms: matrix b of each operand starts b * stride
+        // elements in, so a stride of 0 broadcasts one operand (e.g.
+        // shared weights) to every product.
+        // ------------------------------------------------------------
+
+        template <class T>
+        void batched_gemm(const T *a, size_t stride_a, const T *b, size_t stride_b, T *c, size_t stride_c,
+                          size_t batch, size_t m, size_t k, size_t n, T alpha = T(1), T beta = T())
+        {
+            for_each_gemm_tile(batch, m, k, n, [=](size_t p, size_t i0, size_t i1) {
+                const T *pa = a + p * stride_a, *pb = b + p * stride_b;
+                T *pc = c + p * stride_c;
+                scale_rows(pc + i0 * n, i1 - i0, n, beta);
+
+                for (size_t k0 = 0; k0 < k; k0 += GemmDepth)
+                    for (size_t j0 = 0; j0 < n; j0 += GemmCols)
+                    {
+                        const size_t k1 = std::min(k, k0 + GemmDepth), j1 = std::min(n, j0 + GemmCols);
+                        for (size_t i = i0; i < i1; i++)
+                        {
+                            T *row = pc + i * n;
+                            for (size_t q = k0; q < k1; q++)
+                            {
+                                const T scale = alpha * pa[i * k + q];
+                                const T *panel = pb + q * n;
+#pragma omp simd
+                                for (size_t j = j0; j < j1; j++)
+                                    row[j] += scale * panel[j];
+                            }
+                        }
+                    }
+            });
+        }
+
+        template <class T>
+        void batched_gemm_tn(const T *a, size_t stride_a, const T *b, size_t stride_b, T *c, size_t stride_c,
+                             size_t batch, size_t m, size_t k, size_t n, T alpha = T(1), T beta = T())
+        {
+            for_each_gemm_tile(batch, m, k, n, [=](size_t p, size_t i0, size_t i1) {
+                const T *pa = a + p * stride_a, *pb = b + p * stride_b;
+                T *pc = c + p * stride_c;
+                scale_rows(pc + i0 * n, i1 - i0, n, beta);
+
+                for (size_t j0 = 0; j0 < n; j0 += GemmCols)
+                {
+                    const size_t j1 = std::min(n, j0 + GemmCols);
+                    for (size_t q = 0; q < k; q++)
+                    {
+                        const T *column = pa + q * m;
+                        const T *panel = pb + q * n;
+                        for (size_t i = i0; i < i1; i++)
+                        {
+                            T *row = pc + i * n;
+                            const T scale = alpha * column[i];
+#pragma omp simd
+                            for (size_t j = j0; j < j1; j++)
+                                row[j] += scale * panel[j];
+                        }
+                    }
+                }
+            });
+        }
+
+        template <class T>
+        void batched_gemm_nt(const T *a, size_t stride_a, const T *b, size_t stride_b, T *c, size_t stride_c,
+                             size_t batch, size_t m, size_t k, size_t n, T alpha = T(1), T beta = T())
+        {
+            for_each_gemm_tile(batch, m, k, n, [=](size_t p, size_t i0, size_t i1) {
+                const T *pa = a + p * stride_a, *pb = b + p * stride_b;
+                T *pc = c + p * stride_c;
+
+                for (size_t i = i0; i < i1; i++)
+                {
+                    const T *row_a = pa + i * k;
+                    T *row = pc + i * n;
+                    for (size_t j = 0; j < n; j++)
+                    {
+                        const T *row_b = pb + j * k;
+                        T sum = T();
+#pragma omp simd reduction(+ : sum)
+                        for (size_t q = 0; q < k; q++)
+                            sum += row_a[q] * row_b[q];
+                        row[j] = alpha * sum + (beta == T() ? T() : beta * row[j]);
+                    }
+                }
+            });
+        }
+
+        template <class T>
+        void gemm(const T *a, const T *b, T *c, size_t m, size_t k, size_t n, T alpha = T(1), T beta = T())
+        {
+            batched_gemm(a, 0, b, 0, c, 0, 1, m, k, n, alpha, beta);
+        }
+
+        template <class T>
+        void gemm_tn(const T *a, const T *b, T *c, size_t m, size_t k, size_t n, T alpha = T(1), T beta = T())
+        {
+            batched_gemm_tn(a, 0, b, 0, c, 0, 1, m, k, n, alpha, beta);
+        }
+
+        template <class T>
+        void gemm_nt(const T *a, const T *b, T *c, size_t m, size_t k, size_t n, T alpha = T(1), T beta = T())
+        {
+            batched_gemm_nt(a, 0, b, 0, c, 0, 1, m, k, n, alpha, beta);
+        }
+
+        // ------------------------------------------------------------
+        // Fused backward of y = x w + bias with an SGD step, in one sweep
+        // over dy:
+        //
+        //   dx    = dy w^T            (with the weights before the step)
+        //   w    -= rate * x^T dy
+        //   bias -= rate * sum_b dy
+        //
+        // x [batch, in], dy [batch, out], w [in, out]. Threads own tiles of
+        // weight rows; each tile reads every dy row once, producing its
+        // columns of dx and accumulating its weight gradient, which is then
+        // applied in the epilogue. The first tile also sums dy for the bias.
+        // ------------------------------------------------------------
+
+        constexpr size_t LinearTile = 8;
+
+        template <class T>
+        void linear_backward(const T *x, const T *dy, T *w, T *bias, T *dx,
+                             size_t batch, size_t in, size_t out, T rate)
+        {
+            const size_t tiles = (in + LinearTile - 1) / LinearTile;
+
+#pragma omp parallel if (batch * in * out >= ParallelThreshold)
+            {
+                std::vector<T> grad(LinearTile * out), bias_grad;
+
+#pragma omp for
+                for (long t = 0; t < (long)tiles; t++)
+                {
+                    const size_t i0 = t * LinearTile, rows = std::min(LinearTile, in - i0);
+                    const bool with_bias = t == 0;
+                    std::fill(grad.begin(), grad.end(), T());
+                    if (with_bias)
+                        bias_grad.assign(out, T());
+
+                    for (size_t b = 0; b < batch; b++)
+                    {
+                        const T *g = dy + b * out;
+                        for (size_t r = 0; r < rows; r++)
+                        {
+                            const T *weights = w + (i0 + r) * out;
+                            T sum = T();
+#pragma omp simd reduction(+ : sum)
+                            for (size_t o = 0; o < out; o++)
+                                sum += g[o] * weights[o];
+                            dx[b * in + i0 + r] = sum;
+                        }
+
+                        for (size_t r = 0; r < rows; r++)
+                        {
+                            const T scale = x[b * in + i0 + r];
+                            T *acc = grad.data() + r * out;
+#pragma omp simd
+                            for (size_t o = 0; o < out; o++)
+                                acc[o] += scale * g[o];
+                        }
+
+                        if (with_bias)
+                        {
+                            T *acc = bias_grad.data();
+#pragma omp simd
+                            for (size_t o = 0; o < out; o++)
+                                acc[o] += g[o];
+                        }
+                    }
+
+                    for (size_t r = 0; r < rows; r++)
+                    {
+                        T *weights = w + (i0 + r) * out;
+                        const T *acc = grad.data() + r * out;
+#pragma omp simd
+                        for (size_t o = 0; o < out; o++)
+                            weights[o] -= rate * acc[o];
+                    }
+
+                    if (with_bias)
+                        for (size_t o = 0; o < out; o++)
+                            bias[o] -= rate * bias_grad[o];
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef KERNELS_IM2COL_H_
+#define KERNELS_IM2COL_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Patch extraction for convolution as GEMM.
+        //
+        // The column matrix has one row per output pixel, ordered
+        // [batch, oy, ox], and one column per (c, ky, kx) tap, i.e. the
+        // row-major [Batch * OH * OW, C * KH * KW] operand of the forward
+        // product. Both directions are written in a single pass; padding
+        // taps read as zero and are never materialized in the image.
+        // ------------------------------------------------------------
+
+        constexpr size_t conv_output(size_t input, size_t kernel, size_t stride, size_t padding, size_t dilation)
+        {
+            return (input + 2 * padding - dilation * (kernel - 1) - 1) / stride + 1;
+        }
+
+        struct Conv2DGeometry
+        {
+            size_t channels;
+            size_t ih, iw;
+            size_t kh, kw;
+            size_t sh = 1, sw = 1;
+            size_t ph = 0, pw = 0;
+            size_t dh = 1, dw = 1;
+
+            constexpr size_t oh() const { return conv_output(ih, kh, sh, ph, dh); }
+            constexpr size_t ow() const { return conv_output(iw, kw, sw, pw, dw); }
+            constexpr size_t patch() const { return channels * kh * kw; }
+        };
+
+        // Rows are independent, so the work is split over batch * OH.
+        // image_stride is the distance between images, when g.channels is a
+        // channel group of a wider tensor (0: the images are packed).
+        template <class T>
+        void im2col(const T *in, T *col, size_t batch, const Conv2DGeometry &g, size_t image_stride = 0)
+        {
+            const size_t oh = g.oh(), ow = g.ow(), patch = g.patch();
+            const size_t stride = image_stride ? image_stride : g.channels * g.ih * g.iw;
+            const long span = (long)((g.kw - 1) * g.dw);
+
+#pragma omp parallel for if (batch * oh * ow * patch >= ParallelThreshold)
+            for (long r = 0; r < (long)(batch * oh); r++)
+            {
+                const size_t b = r / oh, oy = r % oh;
+                const T *image = in + b * stride;
+                const long y0 = (long)(oy * g.sh) - (long)g.ph;
+
+                for (size_t ox = 0; ox < ow; ox++)
+                {
+                    T *dst = col + (r * ow + ox) * patch;
+                    const long x0 = (long)(ox * g.sw) - (long)g.pw;
+                    const bool inside = x0 >= 0 && x0 + span < (long)g.iw;
+
+                    for (size_t c = 0; c < g.channels; c++)
+                        for (size_t ky = 0; ky < g.kh; ky++, dst += g.kw)
+                        {
+                            const long y = y0 + (long)(ky * g.dh);
+                            if (y < 0 || y >= (long)g.ih)
+                            {
+                                for (size_t kx = 0; kx < g.kw; kx++)
+                                    dst[kx] = T();
+                                continue;
+                            }
+
+                            const T *line = image + (c * g.ih + y) * g.iw;
+                            if (inside)
+                            {
+#pragma omp simd
+                                for (size_t kx = 0; kx < g.kw; kx++)
+                                    dst[kx] = line[x0 + kx * g.dw];
+                            }
+                            else
+                            {
+                                for (size_t kx = 0; kx < g.kw; kx++)
+                                {
+                                    const long x = x0 + (long)(kx * g.dw);
+                                    dst[kx] = x >= 0 && x < (long)g.iw ? line[x] : T();
+                                }
+                            }
+                        }
+                }
+            }
+        }
+
+        // Overlapping windows scatter into the same pixels, so each thread
+        // owns whole images and walks their column rows front to back.
+        template <class T>
+        void col2im(const T *col, T *out, size_t batch, const Conv2DGeometry &g, size_t image_stride = 0)
+        {
+            const size_t oh = g.oh(), ow = g.ow(), patch = g.patch();
+            const size_t image_size = g.channels * g.ih * g.iw;
+            const size_t stride = image_stride ? image_stride : image_size;
+
+#pragma omp parallel for if (batch * oh * ow * patch >= ParallelThreshold)
+            for (long b = 0; b < (long)batch; b++)
+            {
+                T *image = out + b * stride;
+                for (size_t i = 0; i < image_size; i++)
+                    image[i] = T();
+
+                const T *src = col + b * oh * ow * patch;
+                for (size_t oy = 0; oy < oh; oy++)
+                {
+                    const long y0 = (long)(oy * g.sh) - (long)g.ph;
+                    for (size_t ox = 0; ox < ow; ox++)
+                    {
+                        const long x0 = (long)(ox * g.sw) - (long)g.pw;
+                        for (size_t c = 0; c < g.channels; c++)
+                            for (size_t ky = 0; ky < g.kh; ky++, src += g.kw)
+                            {
+                                const long y = y0 + (long)(ky * g.dh);
+                                if (y < 0 || y >= (long)g.ih)
+                                    continue;
+
+                                T *line = image + (c * g.ih + y) * g.iw;
+                                for (size_t kx = 0; kx < g.kw; kx++)
+                                {
+                                    const long x = x0 + (long)(kx * g.dw);
+                                    if (x >= 0 && x < (long)g.iw)
+                                        line[x] += src[kx];
+                                }
+                            }
+                    }
+                }
+            }
+        }
+
+        // ------------------------------------------------------------
+        // The same for channel-blocked images, [batch, C / block, H, W, block]
+        // (block == C is NHWC). Patch columns are ordered (c / block, ky, kx,
+        // c % block), so each tap copies `block` contiguous channels and a
+        // whole undilated kernel row is a single run of kw * block values.
+        // ------------------------------------------------------------
+
+        template <class T>
+        void im2col_blocked(const T *in, T *col, size_t batch, const Conv2DGeometry &g, size_t block)
+        {
+            const size_t oh = g.oh(), ow = g.ow(), patch = g.patch();
+            const size_t blocks = g.channels / block, run = g.kw * block;
+            const long span = (long)((g.kw - 1) * g.dw);
+
+#pragma omp parallel for if (batch * oh * ow * patch >= ParallelThreshold)
+            for (long r = 0; r < (long)(batch * oh); r++)
+            {
+                const size_t b = r / oh, oy = r % oh;
+                const T *image = in + b * g.channels * g.ih * g.iw;
+                const long y0 = (long)(oy * g.sh) - (long)g.ph;
+
+                for (size_t ox = 0; ox < ow; ox++)
+                {
+                    T *dst = col + (r * ow + ox) * patch;
+                    const long x0 = (long)(ox * g.sw) - (long)g.pw;
+                    const bool inside = x0 >= 0 && x0 + span < (long)g.iw;
+
+                    for (size_t k = 0; k < blocks; k++)
+                        for (size_t ky = 0; ky < g.kh; ky++, dst += run)
+                        {
+                            const long y = y0 + (long)(ky * g.dh);
+                            if (y < 0 || y >= (long)g.ih)
+                            {
+                                for (size_t i = 0; i < run; i++)
+                                    dst[i] = T();
+                                continue;
+                            }
+
+                            const T *line = image + ((k * g.ih + y) * g.iw) * block;
+                            if (inside && g.dw == 1)
+                            {
+                                const T *src = line + x0 * block;
+#pragma omp simd
+                                for (size_t i = 0; i < run; i++)
+                                    dst[i] = src[i];
+                                continue;
+                            }
+
+                            for (size_t kx = 0; kx < g.kw; kx++)
+                            {
+                                const long x = x0 + (long)(kx * g.dw);
+                                if (x >= 0 && x < (long)g.iw)
+                                    std::copy(line + x * block, line + (x + 1) * block, dst + kx * block);
+                                else
+                                    std::fill(dst + kx * block, dst + (kx + 1) * block, T());
+                            }
+                        }
+                }
+            }
+        }
+
+        template <class T>
+        void col2im_blocked(const T *col, T *out, size_t batch, const Conv2DGeometry &g, size_t block)
+        {
+            const size_t oh = g.oh(), ow = g.ow(), patch = g.patch();
+            const size_t image_size = g.channels * g.ih * g.iw;
+            const size_t blocks = g.channels / block, run = g.kw * block;
+
+#pragma omp parallel for if (batch * oh * ow * patch >= ParallelThreshold)
+            for (long b = 0; b < (long)batch; b++)
+            {
+                T *image = out + b * image_size;
+                for (size_t i = 0; i < image_size; i++)
+                    image[i] = T();
+
+                const T *src = col + b * oh * ow * patch;
+                for (size_t oy = 0; oy < oh; oy++)
+                {
+                    const long y0 = (long)(oy * g.sh) - (long)g.ph;
+                    for (size_t ox = 0; ox < ow; ox++)
+                    {
+                        const long x0 = (long)(ox * g.sw) - (long)g.pw;
+                        for (size_t k = 0; k < blocks; k++)
+                            for (size_t ky = 0; ky < g.kh; ky++, src += run)
+                            {
+                                const long y = y0 + (long)(ky * g.dh);
+                                if (y < 0 || y >= (long)g.ih)
+                                    continue;
+
+                                T *line = image + ((k * g.ih + y) * g.iw) * block;
+                                for (size_t kx = 0; kx < g.kw; kx++)
+                                {
+                                    const long x = x0 + (long)(kx * g.dw);
+                                    if (x < 0 || x >= (long)g.iw)
+                                        continue;
+#pragma omp simd
+                                    for (size_t i = 0; i < block; i++)
+                                        line[x * block + i] += src[kx * block + i];
+                                }
+                            }
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
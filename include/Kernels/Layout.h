@@ -0,0 +1,62 @@
+#ifndef KERNELS_LAYOUT_H_
+#define KERNELS_LAYOUT_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Channel-blocked activations: [batch, channels / block, pixels, block].
+        //
+        // block == 1 is NCHW, block == channels is NHWC (and the row-major
+        // [batch * pixels, channels] GEMM output), anything in between is
+        // nChw<block>c. Blocks are assumed to divide each other.
+        // ------------------------------------------------------------
+
+        // Converts between block sizes, optionally adding a per-channel bias.
+        template <class T>
+        void reorder_blocked(const T *in, T *out, size_t batch, size_t channels, size_t pixels,
+                             size_t in_block, size_t out_block, const T *bias = nullptr)
+        {
+            if (in_block == out_block && !bias)
+            {
+                std::copy(in, in + batch * channels * pixels, out);
+                return;
+            }
+
+            // Runs of `step` channels stay contiguous on both sides.
+            const size_t step = std::min(in_block, out_block);
+            const size_t runs = channels / step;
+
+#pragma omp parallel for if (batch * channels * pixels >= ParallelThreshold)
+            for (long t = 0; t < (long)(batch * runs); t++)
+            {
+                const size_t b = t / runs, c = t % runs * step;
+                const T *src = in + ((b * channels + c - c % in_block) * pixels) + c % in_block;
+                T *dst = out + ((b * channels + c - c % out_block) * pixels) + c % out_block;
+
+                if (bias)
+                {
+                    for (size_t p = 0; p < pixels; p++)
+#pragma omp simd
+                        for (size_t i = 0; i < step; i++)
+                            dst[p * out_block + i] = src[p * in_block + i] + bias[c + i];
+                }
+                else
+                {
+                    for (size_t p = 0; p < pixels; p++)
+#pragma omp simd
+                        for (size_t i = 0; i < step; i++)
+                            dst[p * out_block + i] = src[p * in_block + i];
+                }
+            }
+        }
+    }
+}
+
+#endif
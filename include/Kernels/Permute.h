@@ -0,0 +1,195 @@
+#ifndef KERNELS_PERMUTE_H_
+#define KERNELS_PERMUTE_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Axis permutation of a dense row-major tensor.
+        //
+        // make_permute_plan drops size-1 axes and merges source axes that
+        // stay adjacent and in order in the output, so e.g. <0, 4, 5, 1, 2, 3>
+        // over [B, 1, 5, 5, 24, 24] becomes a batch of [25, 576] transposes.
+        // It is constexpr so the plan of a static shape is built at compile
+        // time. permute then either copies whole rows (innermost axis kept)
+        // or runs a tiled 2-D transpose between the source's innermost axis
+        // and the one that becomes innermost in the output, over every
+        // combination of the remaining axes.
+        // ------------------------------------------------------------
+
+        constexpr size_t PermuteMaxRank = 16;
+        constexpr size_t PermuteBlock = 8;
+        constexpr size_t PermuteTile = 64;
+
+        // Collapsed axes in source order: extent, source stride and the
+        // stride of the same axis in the output.
+        struct PermutePlan
+        {
+            size_t rank = 0;
+            size_t dims[PermuteMaxRank] = {};
+            size_t src_strides[PermuteMaxRank] = {};
+            size_t dst_strides[PermuteMaxRank] = {};
+        };
+
+        // perm[i] is the source axis that becomes output axis i.
+        constexpr PermutePlan make_permute_plan(const size_t *dims, const size_t *perm, size_t rank)
+        {
+            // Output order without size-1 axes.
+            size_t order[PermuteMaxRank] = {}, count = 0;
+            for (size_t i = 0; i < rank; i++)
+                if (dims[perm[i]] != 1)
+                    order[count++] = perm[i];
+
+            // An axis starts a new group unless it directly follows the
+            // previous output axis in the source as well.
+            bool head[PermuteMaxRank] = {};
+            for (size_t i = 0; i < count; i++)
+            {
+                size_t next = i > 0 ? order[i - 1] + 1 : rank;
+                while (next < rank && dims[next] == 1)
+                    next++;
+                head[order[i]] = next != order[i];
+            }
+
+            // Group extents in source order, then output strides in
+            // output order.
+            size_t extent[PermuteMaxRank] = {}, group_of[PermuteMaxRank] = {}, groups = 0;
+            for (size_t a = 0; a < rank; a++)
+            {
+                if (dims[a] == 1)
+                    continue;
+                if (head[a])
+                    extent[groups++] = 1;
+                group_of[a] = groups - 1;
+                extent[groups - 1] *= dims[a];
+            }
+
+            PermutePlan plan;
+            plan.rank = groups;
+            size_t stride = 1;
+            for (size_t g = groups; g-- > 0;)
+            {
+                plan.dims[g] = extent[g];
+                plan.src_strides[g] = stride;
+                stride *= extent[g];
+            }
+
+            stride = 1;
+            for (size_t i = count; i-- > 0;)
+            {
+                const size_t g = group_of[order[i]];
+                if (head[order[i]])
+                {
+                    plan.dst_strides[g] = stride;
+                    stride *= extent[g];
+                }
+            }
+            return plan;
+        }
+
+        // dst[c * dst_stride + r] = src[r * src_stride + c] for a rows x cols
+        // block, through 8 x 8 register tiles.
+        template <class T>
+        void transpose_block(const T *src, size_t src_stride, T *dst, size_t dst_stride, size_t rows, size_t cols)
+        {
+            size_t i = 0;
+            for (; i + PermuteBlock <= rows; i += PermuteBlock)
+            {
+                size_t j = 0;
+                for (; j + PermuteBlock <= cols; j += PermuteBlock)
+                {
+                    T tile[PermuteBlock][PermuteBlock];
+                    for (size_t r = 0; r < PermuteBlock; r++)
+#pragma omp simd
+                        for (size_t c = 0; c < PermuteBlock; c++)
+                            tile[c][r] = src[(i + r) * src_stride + j + c];
+                    for (size_t c = 0; c < PermuteBlock; c++)
+#pragma omp simd
+                        for (size_t r = 0; r < PermuteBlock; r++)
+                            dst[(j + c) * dst_stride + i + r] = tile[c][r];
+                }
+                for (; j < cols; j++)
+                    for (size_t r = 0; r < PermuteBlock; r++)
+                        dst[j * dst_stride + i + r] = src[(i + r) * src_stride + j];
+            }
+            for (; i < rows; i++)
+                for (size_t j = 0; j < cols; j++)
+                    dst[j * dst_stride + i] = src[i * src_stride + j];
+        }
+
+        template <class T>
+        void permute(const T *src, T *dst, const PermutePlan &plan)
+        {
+            size_t total = 1;
+            for (size_t a = 0; a < plan.rank; a++)
+                total *= plan.dims[a];
+
+            if (plan.rank <= 1)
+            {
+                std::copy(src, src + total, dst);
+                return;
+            }
+
+            // The source's innermost axis, and the one innermost in the output.
+            const size_t inner = plan.rank - 1;
+            size_t across = 0;
+            while (plan.dst_strides[across] != 1)
+                across++;
+
+            // Every other axis is iterated; a tile splits `across` for the
+            // transpose, or is a whole row for the copy.
+            const bool copy = across == inner;
+            const size_t rows = copy ? 1 : plan.dims[across], cols = plan.dims[inner];
+            const size_t tiles = (rows + PermuteTile - 1) / PermuteTile;
+            const size_t outer = total / (rows * cols);
+
+            auto run = [&](size_t t) {
+                size_t rest = t / tiles, src_offset = 0, dst_offset = 0;
+                for (size_t a = plan.rank; a-- > 0;)
+                {
+                    if (a == inner || (!copy && a == across))
+                        continue;
+                    const size_t index = rest % plan.dims[a];
+                    rest /= plan.dims[a];
+                    src_offset += index * plan.src_strides[a];
+                    dst_offset += index * plan.dst_strides[a];
+                }
+
+                if (copy)
+                {
+                    const T *in = src + src_offset;
+                    T *out = dst + dst_offset;
+#pragma omp simd
+                    for (size_t j = 0; j < cols; j++)
+                        out[j] = in[j];
+                    return;
+                }
+
+                const size_t r0 = t % tiles * PermuteTile, r1 = std::min(rows, r0 + PermuteTile);
+                for (size_t c0 = 0; c0 < cols; c0 += PermuteTile)
+                    transpose_block(src + src_offset + r0 * plan.src_strides[across] + c0, plan.src_strides[across],
+                                    dst + dst_offset + c0 * plan.dst_strides[inner] + r0, plan.dst_strides[inner],
+                                    r1 - r0, std::min(cols, c0 + PermuteTile) - c0);
+            };
+
+            if (total < ParallelThreshold)
+            {
+                for (size_t t = 0; t < outer * tiles; t++)
+                    run(t);
+                return;
+            }
+
+#pragma omp parallel for
+            for (long t = 0; t < (long)(outer * tiles); t++)
+                run(t);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef KERNELS_POOL_H_
+#define KERNELS_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // 2-D pooling over `planes` contiguous ih x iw images (Batch * C for
+        // an NCHW tensor). Windows are read in place with strided row loads;
+        // the inner loop runs along the output row. Planes are processed in
+        // parallel.
+        // ------------------------------------------------------------
+
+        constexpr size_t pool_output(size_t input, size_t kernel, size_t stride)
+        {
+            return (input - kernel) / stride + 1;
+        }
+
+        template <class T>
+        void avg_pool2d(const T *in, T *out, size_t planes, size_t ih, size_t iw,
+                        size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t oh = pool_output(ih, kh, sh), ow = pool_output(iw, kw, sw);
+            const size_t area = kh * kw;
+
+#pragma omp parallel for if (planes * ih * iw >= ParallelThreshold)
+            for (long p = 0; p < (long)planes; p++)
+            {
+                const T *src = in + p * ih * iw;
+                T *dst = out + p * oh * ow;
+
+                for (size_t y = 0; y < oh; y++)
+                {
+                    T *row = dst + y * ow;
+                    for (size_t x = 0; x < ow; x++)
+                        row[x] = T();
+
+                    for (size_t ky = 0; ky < kh; ky++)
+                    {
+                        const T *line = src + (y * sh + ky) * iw;
+                        for (size_t kx = 0; kx < kw; kx++)
+#pragma omp simd
+                            for (size_t x = 0; x < ow; x++)
+                                row[x] += line[x * sw + kx];
+                    }
+
+                    if constexpr (std::is_floating_point_v<T>)
+                    {
+                        const T scale = T(1) / T(area);
+#pragma omp simd
+                        for (size_t x = 0; x < ow; x++)
+                            row[x] *= scale;
+                    }
+                    else
+                    {
+                        for (size_t x = 0; x < ow; x++)
+                            row[x] /= (T)area;
+                    }
+                }
+            }
+        }
+
+        template <class T>
+        void avg_pool2d_backward(const T *dout, T *din, size_t planes, size_t ih, size_t iw,
+                                 size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t oh = pool_output(ih, kh, sh), ow = pool_output(iw, kw, sw);
+            const size_t area = kh * kw;
+
+#pragma omp parallel for if (planes * ih * iw >= ParallelThreshold)
+            for (long p = 0; p < (long)planes; p++)
+            {
+                const T *src = dout + p * oh * ow;
+                T *dst = din + p * ih * iw;
+
+                for (size_t i = 0; i < ih * iw; i++)
+                    dst[i] = T();
+
+                for (size_t y = 0; y < oh; y++)
+                {
+                    const T *row = src + y * ow;
+                    for (size_t ky = 0; ky < kh; ky++)
+                    {
+                        T *line = dst + (y * sh + ky) * iw;
+                        for (size_t kx = 0; kx < kw; kx++)
+#pragma omp simd
+                            for (size_t x = 0; x < ow; x++)
+                                line[x * sw + kx] += row[x] / (T)area;
+                    }
+                }
+            }
+        }
+
+        // mask receives, per output element, the flat index of the chosen
+        // input element inside its plane.
+        template <class T>
+        void max_pool2d(const T *in, T *out, uint32_t *mask, size_t planes, size_t ih, size_t iw,
+                        size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t oh = pool_output(ih, kh, sh), ow = pool_output(iw, kw, sw);
+
+#pragma omp parallel for if (planes * ih * iw >= ParallelThreshold)
+            for (long p = 0; p < (long)planes; p++)
+            {
+                const T *src = in + p * ih * iw;
+                T *dst = out + p * oh * ow;
+                uint32_t *idx = mask + p * oh * ow;
+
+                for (size_t y = 0; y < oh; y++)
+#pragma omp simd
+                    for (size_t x = 0; x < ow; x++)
+                    {
+                        // Selects rather than branches: pooling inputs are
+                        // effectively random and would defeat the predictor.
+                        uint32_t best_idx = (uint32_t)(y * sh * iw + x * sw);
+                        T best = src[best_idx];
+                        for (size_t ky = 0; ky < kh; ky++)
+                            for (size_t kx = 0; kx < kw; kx++)
+                            {
+                                uint32_t i = (uint32_t)((y * sh + ky) * iw + x * sw + kx);
+                                bool greater = src[i] > best;
+                                best = greater ? src[i] : best;
+                                best_idx = greater ? i : best_idx;
+                            }
+                        dst[y * ow + x] = best;
+                        idx[y * ow + x] = best_idx;
+                    }
+            }
+        }
+
+        template <class T>
+        void max_pool2d_backward(const T *dout, const uint32_t *mask, T *din, size_t planes, size_t ih, size_t iw,
+                                 size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t oh = pool_output(ih, kh, sh), ow = pool_output(iw, kw, sw);
+
+#pragma omp parallel for if (planes * ih * iw >= ParallelThreshold)
+            for (long p = 0; p < (long)planes; p++)
+            {
+                const T *src = dout + p * oh * ow;
+                const uint32_t *idx = mask + p * oh * ow;
+                T *dst = din + p * ih * iw;
+
+                for (size_t i = 0; i < ih * iw; i++)
+                    dst[i] = T();
+                for (size_t o = 0; o < oh * ow; o++)
+                    dst[idx[o]] += src[o];
+            }
+        }
+        // ------------------------------------------------------------
+        // Channel-blocked variants over `images` ih x iw x block images
+        // (Batch * C / block of them): the window loops are outermost and
+        // the inner loop runs over the block's contiguous channels.
+        // ------------------------------------------------------------
+
+        template <class T>
+        void avg_pool2d_blocked(const T *in, T *out, size_t images, size_t ih, size_t iw, size_t block,
+                                size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t oh = pool_output(ih, kh, sh), ow = pool_output(iw, kw, sw);
+            const T scale = T(1) / T(kh * kw);
+
+#pragma omp parallel for if (images * ih * iw * block >= ParallelThreshold)
+            for (long r = 0; r < (long)(images * oh); r++)
+            {
+                const size_t image = r / oh, oy = r % oh;
+                const T *src = in + image * ih * iw * block;
+
+                for (size_t ox = 0; ox < ow; ox++)
+                {
+                    T *dst = out + (r * ow + ox) * block;
+                    for (size_t i = 0; i < block; i++)
+                        dst[i] = T();
+
+                    for (size_t ky = 0; ky < kh; ky++)
+                        for (size_t kx = 0; kx < kw; kx++)
+                        {
+                            const T *tap = src + ((oy * sh + ky) * iw + ox * sw + kx) * block;
+#pragma omp simd
+                            for (size_t i = 0; i < block; i++)
+                                dst[i] += tap[i];
+                        }
+
+                    if constexpr (std::is_floating_point_v<T>)
+                    {
+#pragma omp simd
+                        for (size_t i = 0; i < block; i++)
+                            dst[i] *= scale;
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < block; i++)
+                            dst[i] /= (T)(kh * kw);
+                    }
+                }
+            }
+        }
+
+        template <class T>
+        void avg_pool2d_blocked_backward(const T *dout, T *din, size_t images, size_t ih, size_t iw, size_t block,
+                                         size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t oh = pool_output(ih, kh, sh), ow = pool_output(iw, kw, sw);
+            const size_t area = kh * kw;
+
+#pragma omp parallel for if (images * ih * iw * block >= ParallelThreshold)
+            for (long p = 0; p < (long)images; p++)
+            {
+                const T *src = dout + p * oh * ow * block;
+                T *dst = din + p * ih * iw * block;
+
+                for (size_t i = 0; i < ih * iw * block; i++)
+                    dst[i] = T();
+
+                for (size_t oy = 0; oy < oh; oy++)
+                    for (size_t ox = 0; ox < ow; ox++)
+                    {
+                        const T *grad = src + (oy * ow + ox) * block;
+                        for (size_t ky = 0; ky < kh; ky++)
+                            for (size_t kx = 0; kx < kw; kx++)
+                            {
+                                T *tap = dst + ((oy * sh + ky) * iw + ox * sw + kx) * block;
+#pragma omp simd
+                                for (size_t i = 0; i < block; i++)
+                                    tap[i] += grad[i] / (T)area;
+                            }
+                    }
+            }
+        }
+
+        // mask holds the flat index of the chosen element inside its image.
+        template <class T>
+        void max_pool2d_blocked(const T *in, T *out, uint32_t *mask, size_t images, size_t ih, size_t iw, size_t block,
+                                size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t oh = pool_output(ih, kh, sh), ow = pool_output(iw, kw, sw);
+
+#pragma omp parallel for if (images * ih * iw * block >= ParallelThreshold)
+            for (long r = 0; r < (long)(images * oh); r++)
+            {
+                const size_t image = r / oh, oy = r % oh;
+                const T *src = in + image * ih * iw * block;
+
+                for (size_t ox = 0; ox < ow; ox++)
+                {
+                    T *dst = out + (r * ow + ox) * block;
+                    uint32_t *idx = mask + (r * ow + ox) * block;
+                    const uint32_t first = (uint32_t)((oy * sh * iw + ox * sw) * block);
+                    for (size_t i = 0; i < block; i++)
+                    {
+                        dst[i] = src[first + i];
+                        idx[i] = first + (uint32_t)i;
+                    }
+
+                    for (size_t ky = 0; ky < kh; ky++)
+                        for (size_t kx = 0; kx < kw; kx++)
+                        {
+                            const uint32_t base = (uint32_t)(((oy * sh + ky) * iw + ox * sw + kx) * block);
+#pragma omp simd
+                            for (size_t i = 0; i < block; i++)
+                            {
+                                bool greater = src[base + i] > dst[i];
+                                dst[i] = greater ? src[base + i] : dst[i];
+                                idx[i] = greater ? base + (uint32_t)i : idx[i];
+                            }
+                        }
+                }
+            }
+        }
+
+        template <class T>
+        void max_pool2d_blocked_backward(const T *dout, const uint32_t *mask, T *din, size_t images, size_t ih, size_t iw, size_t block,
+                                         size_t kh, size_t kw, size_t sh, size_t sw)
+        {
+            const size_t outputs = pool_output(ih, kh, sh) * pool_output(iw, kw, sw) * block;
+
+#pragma omp parallel for if (images * ih * iw * block >= ParallelThreshold)
+            for (long p = 0; p < (long)images; p++)
+            {
+                const T *src = dout + p * outputs;
+                const uint32_t *idx = mask + p * outputs;
+                T *dst = din + p * ih * iw * block;
+
+                for (size_t i = 0; i < ih * iw * block; i++)
+                    dst[i] = T();
+                for (size_t o = 0; o < outputs; o++)
+                    dst[idx[o]] += src[o];
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef KERNELS_RANDOM_H_
+#define KERNELS_RANDOM_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "Kernels/Reduce.h"
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Philox4x32-10 counter-based generator (Salmon et al., SC'11).
+        //
+        // Output word i of a (seed, stream) sequence is word i % 4 of the
+        // block at counter {i / 4, stream}, so any range can be produced
+        // by any thread in any order with identical results. Blocks are
+        // generated a chunk at a time under `omp simd`, then mapped to
+        // values by a caller-supplied transform.
+        // ------------------------------------------------------------
+
+        constexpr uint32_t PhiloxM0 = 0xD2511F53, PhiloxM1 = 0xCD9E8D57;
+        constexpr uint32_t PhiloxW0 = 0x9E3779B9, PhiloxW1 = 0xBB67AE85;
+        constexpr size_t PhiloxChunk = 1024;
+
+        inline void philox4x32(uint32_t &c0, uint32_t &c1, uint32_t &c2, uint32_t &c3, uint32_t k0, uint32_t k1)
+        {
+            for (int round = 0; round < 10; round++)
+            {
+                const uint64_t p0 = (uint64_t)PhiloxM0 * c0, p1 = (uint64_t)PhiloxM1 * c2;
+                const uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0, n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+                c0 = n0;
+                c1 = (uint32_t)p1;
+                c2 = n2;
+                c3 = (uint32_t)p0;
+                k0 += PhiloxW0;
+                k1 += PhiloxW1;
+            }
+        }
+
+        // Raw words [first, first + count) of the (seed, stream) sequence.
+        // `first` must be a multiple of 4 and `out` must have room for
+        // count rounded up to one.
+        inline void philox_words(uint32_t *out, size_t first, size_t count, uint64_t seed, uint64_t stream)
+        {
+            const uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+            const uint32_t s0 = (uint32_t)stream, s1 = (uint32_t)(stream >> 32);
+            const size_t blocks = (count + 3) / 4;
+
+#pragma omp simd
+            for (size_t j = 0; j < blocks; j++)
+            {
+                const uint64_t counter = first / 4 + j;
+                uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32), c2 = s0, c3 = s1;
+                philox4x32(c0, c1, c2, c3, k0, k1);
+                out[4 * j] = c0;
+                out[4 * j + 1] = c1;
+                out[4 * j + 2] = c2;
+                out[4 * j + 3] = c3;
+            }
+        }
+
+        // out[i] for i < n from words of the sequence; `transform(words,
+        // dst, count)` maps count (<= PhiloxChunk, even unless last) words.
+        template <class T, class Transform>
+        void philox_generate(T *out, size_t n, uint64_t seed, uint64_t stream, Transform transform)
+        {
+            const size_t chunks = (n + PhiloxChunk - 1) / PhiloxChunk;
+
+#pragma omp parallel for if (n >= ParallelThreshold)
+            for (long c = 0; c < (long)chunks; c++)
+            {
+                alignas(64) uint32_t words[PhiloxChunk];
+                const size_t first = c * PhiloxChunk, count = std::min(PhiloxChunk, n - first);
+                philox_words(words, first, count, seed, stream);
+                transform(words, out + first, count);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef KERNELS_REDUCE_H_
+#define KERNELS_REDUCE_H_
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Reductions over a contiguous [outer, n, inner] view, reducing n.
+        //
+        // Contiguous runs are summed pairwise with SIMD lane accumulators,
+        // strided runs (inner > 1) with Kahan compensation per lane; both
+        // keep the error independent of Batch. Work is split across threads
+        // only above ParallelThreshold elements.
+        // ------------------------------------------------------------
+
+        constexpr size_t ParallelThreshold = 1 << 15;
+        constexpr size_t SumLanes = 8;
+        constexpr size_t SumBlock = 256;
+        constexpr size_t LaneChunk = 64;
+
+        template <class T>
+        T pairwise_sum(const T *src, size_t n)
+        {
+            if (n <= SumBlock)
+            {
+                T acc[SumLanes] = {};
+                size_t i = 0;
+                for (; i + SumLanes <= n; i += SumLanes)
+#pragma omp simd
+                    for (size_t l = 0; l < SumLanes; l++)
+                        acc[l] += src[i + l];
+
+                T tail = T();
+                for (; i < n; i++)
+                    tail += src[i];
+
+                for (size_t width = SumLanes / 2; width > 0; width /= 2)
+                    for (size_t l = 0; l < width; l++)
+                        acc[l] += acc[l + width];
+
+                return acc[0] + tail;
+            }
+
+            size_t half = (n / 2 + SumBlock - 1) / SumBlock * SumBlock;
+            return pairwise_sum(src, half) + pairwise_sum(src + half, n - half);
+        }
+
+        // dst[l] = sum_j src[j * stride + l] for l < lanes.
+        template <class T>
+        void strided_sum(const T *src, T *dst, size_t n, size_t stride, size_t lanes)
+        {
+            T sum[LaneChunk], comp[LaneChunk];
+            for (size_t l = 0; l < lanes; l++)
+                sum[l] = comp[l] = T();
+
+            for (size_t j = 0; j < n; j++)
+            {
+                const T *row = src + j * stride;
+                if constexpr (std::is_floating_point_v<T>)
+                {
+#pragma omp simd
+                    for (size_t l = 0; l < lanes; l++)
+                    {
+                        T y = row[l] - comp[l];
+                        T t = sum[l] + y;
+                        comp[l] = (t - sum[l]) - y;
+                        sum[l] = t;
+                    }
+                }
+                else
+                {
+#pragma omp simd
+                    for (size_t l = 0; l < lanes; l++)
+                        sum[l] += row[l];
+                }
+            }
+
+            for (size_t l = 0; l < lanes; l++)
+                dst[l] = sum[l];
+        }
+
+        template <class T>
+        void reduce_sum(const T *src, T *dst, size_t outer, size_t n, size_t inner)
+        {
+            const size_t total = outer * n * inner;
+
+            if (inner == 1)
+            {
+#ifdef _OPENMP
+                // Few long rows: split each row across threads.
+                if (total >= ParallelThreshold && outer < (size_t)omp_get_max_threads())
+                {
+                    for (size_t o = 0; o < outer; o++)
+                    {
+                        const T *row = src + o * n;
+                        const size_t threads = omp_get_max_threads();
+                        T partial[256];
+                        const size_t used = threads < 256 ? threads : 256;
+                        const size_t step = (n + used - 1) / used;
+#pragma omp parallel for num_threads(used)
+                        for (int c = 0; c < (int)used; c++)
+                        {
+                            size_t begin = c * step < n ? c * step : n;
+                            size_t end = begin + step < n ? begin + step : n;
+                            partial[c] = pairwise_sum(row + begin, end - begin);
+                        }
+                        dst[o] = pairwise_sum(partial, used);
+                    }
+                    return;
+                }
+#endif
+
+#pragma omp parallel for if (total >= ParallelThreshold)
+                for (long o = 0; o < (long)outer; o++)
+                    dst[o] = pairwise_sum(src + o * n, n);
+                return;
+            }
+
+            const size_t chunks = (inner + LaneChunk - 1) / LaneChunk;
+#pragma omp parallel for if (total >= ParallelThreshold)
+            for (long t = 0; t < (long)(outer * chunks); t++)
+            {
+                size_t o = t / chunks, l = (t % chunks) * LaneChunk;
+                size_t lanes = inner - l < LaneChunk ? inner - l : LaneChunk;
+                strided_sum(src + o * n * inner + l, dst + o * inner + l, n, inner, lanes);
+            }
+        }
+
+        // dst[k] = sum_{o, i} src[o][k][i]; the per-channel reduction used for
+        // bias gradients and normalization statistics.
+        template <class T>
+        void reduce_sum_keep(const T *src, T *dst, size_t outer, size_t keep, size_t inner)
+        {
+#pragma omp parallel for if (outer * keep * inner >= ParallelThreshold)
+            for (long k = 0; k < (long)keep; k++)
+            {
+                T sum = T(), comp = T();
+                for (size_t o = 0; o < outer; o++)
+                {
+                    T value = pairwise_sum(src + (o * keep + k) * inner, inner);
+                    if constexpr (std::is_floating_point_v<T>)
+                    {
+                        T y = value - comp;
+                        T t = sum + y;
+                        comp = (t - sum) - y;
+                        sum = t;
+                    }
+                    else
+                    {
+                        sum += value;
+                    }
+                }
+                dst[k] = sum;
+            }
+        }
+
+        template <class T>
+        void reduce_max(const T *src, T *dst, size_t outer, size_t n, size_t inner)
+        {
+#pragma omp parallel for if (outer * n * inner >= ParallelThreshold)
+            for (long o = 0; o < (long)outer; o++)
+            {
+                const T *block = src + o * n * inner;
+                T *out = dst + o * inner;
+                for (size_t l = 0; l < inner; l++)
+                    out[l] = block[l];
+                for (size_t j = 1; j < n; j++)
+#pragma omp simd
+                    for (size_t l = 0; l < inner; l++)
+                        out[l] = block[j * inner + l] > out[l] ? block[j * inner + l] : out[l];
+            }
+        }
+
+        // Index of the first maximum along n.
+        template <class T>
+        void reduce_argmax(const T *src, size_t *dst, size_t outer, size_t n, size_t inner)
+        {
+#pragma omp parallel for if (outer * n * inner >= ParallelThreshold)
+            for (long o = 0; o < (long)outer; o++)
+            {
+                const T *block = src + o * n * inner;
+                size_t *out = dst + o * inner;
+                for (size_t l = 0; l < inner; l++)
+                {
+                    T best = block[l];
+                    size_t index = 0;
+                    for (size_t j = 1; j < n; j++)
+                        if (block[j * inner + l] > best)
+                        {
+                            best = block[j * inner + l];
+                            index = j;
+                        }
+                    out[l] = index;
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef KERNELS_SMALL_H_
+#define KERNELS_SMALL_H_
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+namespace StaticNet
+{
+    namespace Kernels
+    {
+        // ------------------------------------------------------------
+        // Kernels for tiny static sizes (logits, per-channel biases, pooling
+        // windows), where loop and dispatch overhead dominates.
+        //
+        // Small<N> at or below SmallThreshold expands every element into
+        // straight-line code through a fold over an index sequence, with no
+        // loop, no threading and nothing that cannot run in a constant
+        // expression (softmax aside, which needs std::exp). Above the
+        // threshold the same interface falls back to plain loops, so
+        // callers choose by size without branching themselves.
+        // ------------------------------------------------------------
+
+        constexpr size_t SmallThreshold = 64;
+
+        // Multiply-adds up to which a matrix product is a plain loop of
+        // Small dots rather than a tiled, threaded GEMM call.
+        constexpr size_t SmallProduct = SmallThreshold * SmallThreshold;
+
+        template <size_t N, class Indices = std::make_index_sequence<N>, bool Unrolled = (N <= SmallThreshold)>
+        struct Small;
+
+        template <size_t N, size_t... I>
+        struct Small<N, std::index_sequence<I...>, true>
+        {
+            // out[i] = op(a[ia[i]], b[ib[i]]); offsets are usually constants
+            // of a broadcast, so every load folds to a fixed address.
+            template <class A, class B, class C, class Op>
+            static constexpr void zip(const A *a, const size_t *ia, const B *b, const size_t *ib, C *out, Op op)
+            {
+                ((out[I] = op(a[ia[I]], b[ib[I]])), ...);
+            }
+
+            template <class A, class B, class C, class Op>
+            static constexpr void zip(const A *a, const B *b, C *out, Op op)
+            {
+                ((out[I] = op(a[I], b[I])), ...);
+            }
+
+            // sum_i a[i] * b[i * stride]
+            template <class T>
+            static constexpr T dot(const T *a, const T *b, size_t stride = 1)
+            {
+                return (T() + ... + (a[I] * b[I * stride]));
+            }
+
+            template <class T>
+            static constexpr T sum(const T *a)
+            {
+                return (T() + ... + a[I]);
+            }
+
+            template <class T>
+            static constexpr T max(const T *a)
+            {
+                T best = a[0];
+                ((best = a[I] > best ? a[I] : best), ...);
+                return best;
+            }
+
+            // First index of the maximum.
+            template <class T>
+            static constexpr size_t argmax(const T *a)
+            {
+                size_t index = 0;
+                ((index = a[I] > a[index] ? I : index), ...);
+                return index;
+            }
+
+            template <class T>
+            static constexpr void softmax(const T *in, T *out)
+            {
+                const T top = max(in);
+                ((out[I] = std::exp(in[I] - top)), ...);
+                const T scale = T(1) / sum(out);
+                ((out[I] *= scale), ...);
+            }
+        };
+
+        template <size_t N, class Indices>
+        struct Small<N, Indices, false>
+        {
+            template <class A, class B, class C, class Op>
+            static void zip(const A *a, const size_t *ia, const B *b, const size_t *ib, C *out, Op op)
+            {
+                for (size_t i = 0; i < N; i++)
+                    out[i] = op(a[ia[i]], b[ib[i]]);
+            }
+
+            template <class A, class B, class C, class Op>
+            static void zip(const A *a, const B *b, C *out, Op op)
+            {
+#pragma omp simd
+                for (size_t i = 0; i < N; i++)
+                    out[i] = op(a[i], b[i]);
+            }
+
+            template <class T>
+            static T dot(const T *a, const T *b, size_t stride = 1)
+            {
+                T result = T();
+                for (size_t i = 0; i < N; i++)
+                    result += a[i] * b[i * stride];
+                return result;
+            }
+
+            template <class T>
+            static T sum(const T *a)
+            {
+                T result = T();
+#pragma omp simd reduction(+ : result)
+                for (size_t i = 0; i < N; i++)
+                    result += a[i];
+                return result;
+            }
+
+            template <class T>
+            static T max(const T *a)
+            {
+                T best = a[0];
+                for (size_t i = 1; i < N; i++)
+                    best = a[i] > best ? a[i] : best;
+                return best;
+            }
+
+            template <class T>
+            static size_t argmax(const T *a)
+            {
+                size_t index = 0;
+                for (size_t i = 1; i < N; i++)
+                    index = a[i] > a[index] ? i : index;
+                return index;
+            }
+
+            template <class T>
+            static void softmax(const T *in, T *out)
+            {
+                const T top = max(in);
+                for (size_t i = 0; i < N; i++)
+                    out[i] = std::exp(in[i] - top);
+                const T scale = T(1) / sum(out);
+#pragma omp simd
+                for (size_t i = 0; i < N; i++)
+                    out[i] *= scale;
+            }
+        };
+    }
+}
+
+#endif
@@ -3,7 +3,9 @@
 #ifndef FLOAT_LAYERS_H_
 #define FLOAT_LAYERS_H_
 
+#include <cmath>
 #include <functional>
+#include <type_traits>
 
 #include "Tensor.h"
 #include "Defines.h"
@@ -12,6 +14,11 @@ namespace StaticNet
 {
     // ------------------------------------------------------------------------
     // Base class for layers
+    //
+    // BaseNet and BaseActivation are the runtime interfaces, for containers
+    // of mixed layers. The implementations below are final, so a call made
+    // through the concrete type (as Layer<Dense<...>, Sigmoid<...>> does)
+    // binds statically and can be inlined.
     // ------------------------------------------------------------------------
 
     template <typename T, size_t Input, size_t Output, size_t Batch>
@@ -19,18 +26,13 @@ namespace StaticNet
     {
     public:
         BaseNet() {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<> dis(-1.0f, 1.0f);
-
-            for (size_t i = 0; i < Input; i++)
-                for (size_t j = 0; j < Output; j++)
-                    weights[i][j] = dis(gen);
-            
-            for (size_t i = 0; i < Output; i++)
-                biases[i] = dis(gen);
+            Random::uniform(weights.data, Input * Output, T(-1), T(1));
+            Random::uniform(biases.data, Output, T(-1), T(1));
         }
-        ~BaseNet() {}
+        virtual ~BaseNet() {}
+
+        using InputTensor = Tensor<T, Batch, Input>;
+        using OutputTensor = Tensor<T, Batch, Output>;
 
         virtual Tensor<T, Batch, Output> Forward(const Tensor<T, Batch, Input> &input) = 0;
         virtual Tensor<T, Batch, Input> Backward(const Tensor<T, Batch, Output> &nextDelta,
@@ -53,6 +55,10 @@ namespace StaticNet
     public:
         BaseActivation() {}
         virtual ~BaseActivation() {}
+
+        using InputTensor = Tensor<T, Batch, Input>;
+        using OutputTensor = Tensor<T, Batch, Input>;
+
         virtual Tensor<T, Batch, Input> Forward(const Tensor<T, Batch, Input> &input) = 0;
         virtual Tensor<T, Batch, Input> Backward(const Tensor<T, Batch, Input> &nextDelta,
                                                  T learningRate) = 0;
@@ -68,31 +74,25 @@ namespace StaticNet
     // ------------------------------------------------------------------------
 
     template <size_t Input, size_t Output, size_t Batch>
-    class Dense : public BaseNet<float, Input, Output, Batch>
+    class Dense final : public BaseNet<float, Input, Output, Batch>
     {
     public:
         Dense() {}
-        Tensor<float, Batch, Output> Forward(const Tensor<float, Batch, Input> &input)
+        Tensor<float, Batch, Output> Forward(const Tensor<float, Batch, Input> &input) override
         {
             layerInput = input;
             Tensor<float, Batch, Output> result = dot(input, this->weights);
-            for (size_t i = 0; i < Batch; i++)
-                result[i] += this->biases;
+            result += this->biases;
 
             return result;
         }
 
         Tensor<float, Batch, Input> Backward(const Tensor<float, Batch, Output> &nextDelta,
-                                             float learningRate)
+                                             float learningRate) override
         {
-            Tensor<float, Batch, Input> delta = dot(nextDelta, get_transposed(this->weights));
-            this->weights -= dot(get_transposed(layerInput), nextDelta) / (float)Batch * learningRate;
-            this->biases -= ([](Tensor<float, Batch, Output> delta) {
-                Tensor<float, Output> result(0.0f);
-                for (size_t i = 0; i < Batch; i++)
-                    result += delta[i];
-                return (result / (float)Batch); 
-            })(nextDelta) * learningRate;
+            Tensor<float, Batch, Input> delta;
+            Kernels::linear_backward(layerInput.data, nextDelta.data, this->weights.data, this->biases.data, delta.data,
+                                     Batch, Input, Output, learningRate / Batch);
 
             return delta;
         }
@@ -102,20 +102,20 @@ namespace StaticNet
     };
 
     template <size_t Input, size_t Batch>
-    class Activation : public BaseActivation<float, Input, Batch>
+    class Activation final : public BaseActivation<float, Input, Batch>
     {
     public:
         Activation(const std::function<float(float)> &activation,
                    const std::function<float(float)> &activationDerivative)
             : m_activation(activation), m_activationDerivative(activationDerivative) {}
 
-        Tensor<float, Batch, Input> Forward(const Tensor<float, Batch, Input> &input)
+        Tensor<float, Batch, Input> Forward(const Tensor<float, Batch, Input> &input) override
         {
             layerInput = input;
             return input.map(m_activation);
         }
         Tensor<float, Batch, Input> Backward(const Tensor<float, Batch, Input> &nextDelta,
-                                             float learningRate)
+                                             float learningRate) override
         {
             return hadamard(nextDelta, layerInput.map(m_activationDerivative));
         }
@@ -127,77 +127,98 @@ namespace StaticNet
         Tensor<float, Batch, Input> layerInput;
     };
 
+    // Sigmoid inline rather than through Defines::Sigmoid, so a statically
+    // bound call compiles down to a plain loop.
     template <size_t Input, size_t Batch>
-    class Sigmoid : public BaseActivation<float, Input, Batch>
+    class Sigmoid final : public BaseActivation<float, Input, Batch>
     {
     public:
-        Sigmoid() : m_activation(Defines::Sigmoid), m_activationDerivative(Defines::SigmoidDerivative_) {}
-
-        Tensor<float, Batch, Input> Forward(const Tensor<float, Batch, Input> &input)
+        Tensor<float, Batch, Input> Forward(const Tensor<float, Batch, Input> &input) override
         {
-            layerOutput = input.map(m_activation);
-            return layerOutput;
+            Tensor<float, Batch, Input> result;
+#pragma omp simd
+            for (size_t i = 0; i < Batch * Input; i++)
+                result.data[i] = 1.0f / (1.0f + std::exp(-input.data[i]));
+            layerOutput = result;
+            return result;
         }
         Tensor<float, Batch, Input> Backward(const Tensor<float, Batch, Input> &nextDelta,
-                                             float learningRate)
+                                             float learningRate) override
         {
-            return hadamard(nextDelta, layerOutput.map(m_activationDerivative));
+            Tensor<float, Batch, Input> delta;
+#pragma omp simd
+            for (size_t i = 0; i < Batch * Input; i++)
+                delta.data[i] = nextDelta.data[i] * layerOutput.data[i] * (1.0f - layerOutput.data[i]);
+            return delta;
         }
 
     private:
-        std::function<float(float)> m_activation;
-        std::function<float(float)> m_activationDerivative;
-
         Tensor<float, Batch, Input> layerOutput;
     };
 
     template <size_t Input, size_t Batch>
-    class Softmax : public BaseActivation<float, Input, Batch>
+    class Softmax final : public BaseActivation<float, Input, Batch>
     {
     public:
-        Softmax() : m_activation(Defines::Softmax<Input>) {}
-        Tensor<float, Batch, Input> Forward(const Tensor<float, Batch, Input> &input)
+        Tensor<float, Batch, Input> Forward(const Tensor<float, Batch, Input> &input) override
         {
-            return input.apply(m_activation);
+            return softmax(input);
         }
 
         Tensor<float, Batch, Input> Backward(const Tensor<float, Batch, Input> &nextDelta,
-                                             float learningRate)
+                                             float learningRate) override
         {
             return nextDelta;
         }
-
-    private:
-        std::function<Tensor<float, Input>(Tensor<float, Input>)> m_activation;
     };
 
-    template <size_t Input, size_t Output, size_t Batch>
+    // ------------------------------------------------------------------------
+    // A net followed by its activation, composed by type:
+    //
+    //   Dense<784, 32, 16> dense;
+    //   Sigmoid<32, 16> sigmoid;
+    //   Layer layer(&dense, &sigmoid);   // Layer<Dense<...>, Sigmoid<...>>
+    //
+    // With concrete types both calls bind statically. PolymorphicLayer holds
+    // the abstract bases instead and accepts any net and activation of the
+    // right shape at runtime.
+    // ------------------------------------------------------------------------
+
+    template <class Net, class Activation>
     class Layer
     {
+        static_assert(std::is_same_v<typename Net::OutputTensor, typename Activation::InputTensor>,
+                      "Layer activation does not match its net");
+
     public:
-        Layer(BaseNet<float, Input, Output, Batch> *net, BaseActivation<float, Output, Batch> *activation)
+        using InputTensor = typename Net::InputTensor;
+        using OutputTensor = typename Activation::OutputTensor;
+
+        Layer(Net *net, Activation *activation)
             : m_net(net), m_activation(activation) {}
 
-        Tensor<float, Batch, Output> Forward(const Tensor<float, Batch, Input> &input)
+        OutputTensor Forward(const InputTensor &input)
         {
-            return (*m_activation)((*m_net)(input));
+            return m_activation->Forward(m_net->Forward(input));
         }
 
-        Tensor<float, Batch, Input> Backward(const Tensor<float, Batch, Output> &nextDelta,
-                                             float learningRate)
+        InputTensor Backward(const OutputTensor &nextDelta, float learningRate)
         {
             return m_net->Backward(m_activation->Backward(nextDelta, learningRate), learningRate);
         }
 
-        Tensor<float, Batch, Output> operator()(const Tensor<float, Batch, Input> &input)
+        OutputTensor operator()(const InputTensor &input)
         {
             return Forward(input);
         }
 
     private:
-        BaseNet<float, Input, Output, Batch> *m_net;
-        BaseActivation<float, Output, Batch> *m_activation;
+        Net *m_net;
+        Activation *m_activation;
     };
+
+    template <size_t Input, size_t Output, size_t Batch>
+    using PolymorphicLayer = Layer<BaseNet<float, Input, Output, Batch>, BaseActivation<float, Output, Batch>>;
 }; // namespace StaticNet
 
 #endif // FLOAT_LAYERS_H_
@@ -0,0 +1,91 @@
+#ifndef LAYOUT_H_
+#define LAYOUT_H_
+
+#include <type_traits>
+
+#include "Tensor.h"
+#include "Kernels/Layout.h"
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // Memory layouts for convolution activations.
+    //
+    // Conv-family modules describe their shapes logically as [C, H, W]; the
+    // layout tag decides the actual Tensor type of a batch. Every layout is a
+    // channel blocking [Batch, C / block, H, W, block]:
+    //
+    //   NCHW       block 1,  Tensor<T, Batch, C, H, W>
+    //   NHWC       block C,  Tensor<T, Batch, H, W, C>
+    //   NChwc<B>   block B,  Tensor<T, Batch, C / B, H, W, B>
+    //
+    // A channel count below B makes one partial block, so the first layer of
+    // a blocked network can still take a single-channel image.
+    // ------------------------------------------------------------------------
+
+    struct NCHW
+    {
+        template <size_t C>
+        static constexpr size_t block = 1;
+
+        template <class T, size_t Batch, size_t C, size_t H, size_t W>
+        using tensor = Tensor<T, Batch, C, H, W>;
+    };
+
+    struct NHWC
+    {
+        template <size_t C>
+        static constexpr size_t block = C;
+
+        template <class T, size_t Batch, size_t C, size_t H, size_t W>
+        using tensor = Tensor<T, Batch, H, W, C>;
+    };
+
+    template <size_t Block>
+    struct NChwc
+    {
+        template <size_t C>
+        static constexpr size_t block = C < Block ? C : Block;
+
+        template <class T, size_t Batch, size_t C, size_t H, size_t W>
+        using tensor = Tensor<T, Batch, C / block<C>, H, W, block<C>>;
+    };
+
+    using NChw8c = NChwc<8>;
+    using NChw16c = NChwc<16>;
+
+    template <class Layout, class T, size_t Batch, size_t C, size_t H, size_t W>
+    using LayoutTensor = typename Layout::template tensor<T, Batch, C, H, W>;
+
+    // Whether a deduced batch tensor is the layout's [C, H, W] tensor.
+    template <class Layout, size_t C, size_t H, size_t W, class Input>
+    struct is_layout_tensor : std::false_type
+    {
+    };
+
+    template <class Layout, size_t C, size_t H, size_t W, class T, size_t Batch, size_t... D>
+    struct is_layout_tensor<Layout, C, H, W, Tensor<T, Batch, D...>>
+        : std::bool_constant<C % Layout::template block<C> == 0 &&
+                             std::is_same_v<Tensor<T, Batch, D...>, LayoutTensor<Layout, T, Batch, C, H, W>>>
+    {
+    };
+
+    template <class Layout, size_t C, size_t H, size_t W, class Input>
+    constexpr bool is_layout_tensor_v = is_layout_tensor<Layout, C, H, W, Input>::value;
+
+    // Converts a [Batch, C, H, W] activation between layouts, e.g.
+    // reorder<NCHW, NHWC, C, H, W>(x). Meant for model boundaries.
+    template <class From, class To, size_t C, size_t H, size_t W, class T, size_t Batch, size_t... D>
+    LayoutTensor<To, T, Batch, C, H, W> reorder(const Tensor<T, Batch, D...> &input)
+    {
+        static_assert(is_layout_tensor_v<From, C, H, W, Tensor<T, Batch, D...>>, "reorder input does not match its layout");
+        STATICNET_PROFILE_KERNEL("reorder", 0, 2 * sizeof(T) * Batch * C * H * W);
+
+        LayoutTensor<To, T, Batch, C, H, W> result;
+        Kernels::reorder_blocked(input.data, result.data, Batch, C, H * W,
+                                 From::template block<C>, To::template block<C>);
+        return result;
+    }
+}
+
+#endif
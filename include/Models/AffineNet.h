@@ -19,9 +19,20 @@ namespace StaticNet
         {
         }
 
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            return decltype(conv1)::cost<Batch>() +
+                   decltype(relu1)::cost<Batch>() +
+                   decltype(conv2)::cost<Batch>() +
+                   decltype(relu2)::cost<Batch>() +
+                   decltype(fc1)::cost<Batch>();
+        }
+
         template <size_t Batch>
         Tensor<float, Batch, 10> forward(const Tensor<float, Batch, 784> &input)
         {
+            STATICNET_PROFILE_MODULE(forward);
             auto x1 = conv1.forward(input);
             auto x2 = relu1.forward(x1);
             auto x3 = conv2.forward(x2);
@@ -32,6 +43,7 @@ namespace StaticNet
         template <size_t Batch>
         Tensor<float, Batch, 784> backward(const Tensor<float, Batch, 10> &delta, float learningRate)
         {
+            STATICNET_PROFILE_MODULE(backward);
             auto d4 = fc1.backward(delta, learningRate);
             auto d3 = relu2.backward(d4, learningRate);
             auto d2 = conv2.backward(d3, learningRate);
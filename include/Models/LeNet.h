@@ -23,10 +23,24 @@ namespace StaticNet
         {
         }
 
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            return decltype(conv1)::cost<Batch>() +
+                   decltype(avgpool1)::cost<Batch>() +
+                   decltype(relu1)::cost<Batch>() +
+                   decltype(conv2)::cost<Batch>() +
+                   decltype(avgpool2)::cost<Batch>() +
+                   decltype(relu2)::cost<Batch>() +
+                   decltype(fc1)::cost<Batch>();
+        }
+
         template <size_t Batch>
         Tensor<float, Batch, 10> forward(const Tensor<float, Batch, 1, 28, 28> &input)
         {
-            auto x1 = conv1.forward(input);
+            STATICNET_PROFILE_MODULE(forward);
+            auto x0 = reorder<NCHW, NHWC, 1, 28, 28>(input);
+            auto x1 = conv1.forward(x0);
             auto x2 = avgpool1.forward(x1);
             auto x3 = relu1.forward(x2);
             auto x4 = conv2.forward(x3);
@@ -39,23 +53,27 @@ namespace StaticNet
         template <size_t Batch>
         Tensor<float, Batch, 1, 28, 28> backward(const Tensor<float, Batch, 10> &delta, float learningRate)
         {
+            STATICNET_PROFILE_MODULE(backward);
             auto d1 = fc1.backward(delta, learningRate);
-            auto d2 = d1.template reshape<Batch, 12, 4, 4>();
+            auto d2 = d1.template reshape<Batch, 4, 4, 12>();
             auto d3 = relu2.backward(d2, learningRate);
             auto d4 = avgpool2.backward(d3, learningRate);
             auto d5 = conv2.backward(d4, learningRate);
             auto d6 = relu1.backward(d5, learningRate);
             auto d7 = avgpool1.backward(d6, learningRate);
-            return conv1.backward(d7, learningRate);
+            auto d8 = conv1.backward(d7, learningRate);
+            return reorder<NHWC, NCHW, 1, 28, 28>(d8);
         }
 
     private:
-        Conv2D<Tensor<float, 1, 28, 28>, Tensor<float, 4, 24, 24>> conv1;
-        AvgPool2D<Tensor<float, 4, 24, 24>, Tensor<float, 4, 12, 12>> avgpool1;
-        ReLU<Tensor<float, 4, 12, 12>> relu1;
-        Conv2D<Tensor<float, 4, 12, 12>, Tensor<float, 12, 8, 8>> conv2;
-        AvgPool2D<Tensor<float, 12, 8, 8>, Tensor<float, 12, 4, 4>> avgpool2;
-        ReLU<Tensor<float, 12, 4, 4>> relu2;
+        // NHWC inside, NCHW at the boundary: the convolutions' GEMM outputs
+        // are used as-is and only the input image and its gradient reorder.
+        Conv2D<Tensor<float, 1, 28, 28>, Tensor<float, 4, 24, 24>, Window2D<5>, NHWC> conv1;
+        AvgPool2D<Tensor<float, 4, 24, 24>, Tensor<float, 4, 12, 12>, NHWC> avgpool1;
+        ReLU<Tensor<float, 12, 12, 4>> relu1;
+        Conv2D<Tensor<float, 4, 12, 12>, Tensor<float, 12, 8, 8>, Window2D<5>, NHWC> conv2;
+        AvgPool2D<Tensor<float, 12, 8, 8>, Tensor<float, 12, 4, 4>, NHWC> avgpool2;
+        ReLU<Tensor<float, 4, 4, 12>> relu2;
         Linear<Tensor<float, 192>, Tensor<float, 10>> fc1;
     };
 }
@@ -1,9 +1,17 @@
 #ifndef MODULE_H_
 #define MODULE_H_
 
+#include <algorithm>
+#include <cassert>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
 
 #include "Tensor.h"
+#include "Layout.h"
+#include "Utils/Async.h"
 
 namespace StaticNet
 {
@@ -13,6 +21,61 @@ namespace StaticNet
         Write = 1
     };
 
+    // ------------------------------------------------------------------------
+    // Static cost of one module (or a chain of them) at a given Batch.
+    //
+    // `cached_bytes` are kept alive by memory() until backward, `peak_bytes`
+    // is the high-water mark of the forward pass excluding the input tensor
+    // (owned by the caller) and including the output. `a + b` chains b after a.
+    // ------------------------------------------------------------------------
+
+    struct ModuleCost
+    {
+        size_t parameters = 0;
+        size_t parameter_bytes = 0;
+        size_t forward_flops = 0;
+        size_t backward_flops = 0;
+        size_t cached_bytes = 0;
+        size_t output_bytes = 0;
+        size_t peak_bytes = 0;
+
+        constexpr ModuleCost operator+(const ModuleCost &next) const
+        {
+            ModuleCost result;
+            result.parameters = parameters + next.parameters;
+            result.parameter_bytes = parameter_bytes + next.parameter_bytes;
+            result.forward_flops = forward_flops + next.forward_flops;
+            result.backward_flops = backward_flops + next.backward_flops;
+            result.cached_bytes = cached_bytes + next.cached_bytes;
+            result.output_bytes = next.output_bytes;
+            result.peak_bytes = std::max(peak_bytes, cached_bytes + output_bytes + next.peak_bytes);
+            return result;
+        }
+
+        constexpr size_t training_bytes() const
+        {
+            return parameter_bytes + peak_bytes;
+        }
+    };
+
+    // Largest of `Batches` whose training footprint fits in `budget` bytes, 0 if none.
+    template <class Model, size_t... Batches>
+    constexpr size_t largest_batch_within(size_t budget)
+    {
+        size_t best = 0;
+        ((Model::template cost<Batches>().training_bytes() <= budget && Batches > best ? best = Batches : best), ...);
+        return best;
+    }
+
+    // Index of the calling thread's set of saved tensors. Threads that run
+    // one model concurrently (see Utils/Hogwild.h) each use their own lane
+    // so their forward/backward caches never alias; everyone else uses 0.
+    inline size_t &memory_lane()
+    {
+        thread_local size_t lane = 0;
+        return lane;
+    }
+
     template <class T>
     class Module
     {
@@ -42,41 +105,242 @@ namespace StaticNet
         template <size_t ...Dim>
         const Tensor<T, Dim...> &memory(AccessType access, const Tensor<T, Dim...> &input = Tensor<T, Dim...>())
         {
-            static Tensor<T, Dim...> mem = Tensor<T, Dim...>();
+            return memory<T, Dim...>(access, input);
+        }
 
-            if (access == AccessType::Read)
-            {
-                return mem;
-            }
-            else if (access == AccessType::Write)
-            {
-                mem = input;
-                return mem;
-            }
+        // Tensors saved for backward live on the instance, one buffer per
+        // type and memory lane, allocated on first use and reused across
+        // steps. While the module is not recording (see record()) writes
+        // are dropped.
+        template <class U, size_t ...Dim>
+        const Tensor<U, Dim...> &memory(AccessType access, const Tensor<U, Dim...> &input = Tensor<U, Dim...>())
+        {
+            return save(access, input, sizeof(U) * TensorUtils::get_size<Dim...>());
+        }
+
+        // Same for a plain struct, e.g. several per-channel arrays saved
+        // together under names of their own.
+        template <class State>
+            requires std::is_trivially_copyable_v<State>
+        const State &memory(AccessType access, const State &input = State())
+        {
+            return save(access, input, sizeof(State));
+        }
+
+        // Enables or disables saving for backward on this subtree, for the
+        // calling thread's lane.
+        void record(bool enabled)
+        {
+            lane().recording = enabled;
+            for (auto child : children)
+                child->record(enabled);
+        }
+
+        // Marks forward passes on this subtree, for the calling thread's
+        // lane, as recomputations of a pass that already ran (see
+        // Checkpoint), so state beyond the saved tensors is updated once.
+        void recompute(bool enabled)
+        {
+            lane().recomputing = enabled;
+            for (auto child : children)
+                child->recompute(enabled);
+        }
 
-            return input;
+        // Switches every Checkpoint segment of this subtree on or off.
+        virtual void checkpoint(bool enabled)
+        {
+            for (auto child : children)
+                child->checkpoint(enabled);
+        }
+
+        // Switches modules with distinct training and inference behaviour
+        // (batch statistics, see BatchNorm) for this subtree.
+        virtual void train(bool enabled)
+        {
+            for (auto child : children)
+                child->train(enabled);
+        }
+
+        // Frees every tensor this subtree saved in the calling thread's lane,
+        // once any overlapped update reading them has finished.
+        void release()
+        {
+            wait_update();
+            lane().memories.clear();
+            for (auto child : children)
+                child->release();
+        }
+
+        // Frees the saved tensors of every lane in this subtree and drops
+        // the lanes reserved above 0, e.g. once a Hogwild run is over.
+        // No thread may be running the module.
+        void release_lanes()
+        {
+            wait_update();
+            lanes.resize(1);
+            lanes[0].memories.clear();
+            for (auto child : children)
+                child->release_lanes();
+        }
+
+        // Lets modules of this subtree run their parameter updates as tasks
+        // on thread_pool(): backward returns its input gradient as soon as it
+        // is computed and the step overlaps with the rest of the backward
+        // pass. A module waits for its own step before it next reads its
+        // parameters. Meant for one training thread; not for Hogwild.
+        void overlap(bool enabled)
+        {
+            if (!enabled)
+                wait_update();
+            overlapping = enabled;
+            for (auto child : children)
+                child->overlap(enabled);
+        }
+
+        // Waits for every parameter update in flight on this subtree.
+        void synchronize()
+        {
+            wait_update();
+            for (auto child : children)
+                child->synchronize();
+        }
+
+        // Bytes currently held by memory() in this subtree.
+        size_t memory_bytes() const
+        {
+            size_t result = 0;
+            for (const auto &lane : lanes)
+                for (const auto &[type, saved] : lane.memories)
+                    result += saved.bytes;
+            for (auto child : children)
+                result += child->memory_bytes();
+            return result;
+        }
+
+        // Makes room for `count` memory lanes on this subtree. Must be
+        // called before threads with a lane above 0 run the module.
+        void reserve_lanes(size_t count)
+        {
+            if (lanes.size() < count)
+                lanes.resize(count);
+            for (auto child : children)
+                child->reserve_lanes(count);
         }
 
         std::vector<Module<T> *> children;
         std::string name = "Module";
         size_t parameters = 0;
         size_t depth = 0;
+
+        Profiler::ModuleCounters profile;
+
+    protected:
+        bool overlapping = false;
+
+        bool recording() const
+        {
+            assert(memory_lane() < lanes.size());
+            return lanes[memory_lane()].recording;
+        }
+
+        bool recomputing() const
+        {
+            assert(memory_lane() < lanes.size());
+            return lanes[memory_lane()].recomputing;
+        }
+
+        // Applies a parameter step now, or as this module's pending task
+        // while overlapping. `step` must own or outlive what it reads; it is
+        // only copied when it becomes a task.
+        template <class Step>
+        void update(Step &&step)
+        {
+            if (!overlapping)
+            {
+                step();
+                return;
+            }
+            wait_update();
+            pending = async(std::forward<Step>(step));
+        }
+
+        void wait_update()
+        {
+            if (pending.valid())
+                pending.get();
+        }
+
+    private:
+        struct Memory
+        {
+            std::shared_ptr<void> tensor;
+            size_t bytes = 0;
+        };
+
+        struct Lane
+        {
+            std::unordered_map<std::type_index, Memory> memories;
+            bool recording = true;
+            bool recomputing = false;
+        };
+
+        // The calling thread's lane, which reserve_lanes() must have made.
+        Lane &lane()
+        {
+            assert(memory_lane() < lanes.size());
+            return lanes[memory_lane()];
+        }
+
+        template <class Saved>
+        const Saved &save(AccessType access, const Saved &input, size_t bytes)
+        {
+            Lane &current = lane();
+            if (access == AccessType::Write && !current.recording)
+                return input;
+
+            auto &saved = current.memories[std::type_index(typeid(Saved))];
+            if (!saved.tensor)
+                saved = {std::make_shared<Saved>(), bytes};
+
+            auto &mem = *static_cast<Saved *>(saved.tensor.get());
+            if (access == AccessType::Write)
+                mem = input;
+            return mem;
+        }
+
+        std::vector<Lane> lanes = std::vector<Lane>(1);
+        Task<> pending;
     };
 }
 
+template <typename T>
+void reset_profile(StaticNet::Module<T> &mod)
+{
+    mod.profile.forward.reset();
+    mod.profile.backward.reset();
+    for (auto child : mod.children)
+        reset_profile(*child);
+}
+
 template <typename T>
 void print(const StaticNet::Module<T>& mod, size_t level = 0)
 {
     std::string tab(level * 4, ' ');
 
+    std::cout << tab << mod.name << " [" << mod.parameters << "]";
+    for (auto [phase, counters] : {std::make_pair("forward", mod.profile.forward.load()),
+                                   std::make_pair("backward", mod.profile.backward.load())})
+        if (counters.calls)
+            std::cout << " {" << phase << ": " << StaticNet::Profiler::format(counters) << "}";
+
     if (mod.children.size()) {
-        std::cout << tab << mod.name << " [" << mod.parameters << "] [\n";
+        std::cout << " [\n";
         for (auto child : mod.children)
             print(*child, level+1);
         std::cout << tab << "]\n";
     }
     else {
-        std::cout << tab << mod.name << " [" << mod.parameters << "]\n";
+        std::cout << "\n";
     }
 }
 
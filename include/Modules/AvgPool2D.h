@@ -2,6 +2,7 @@
 #define AVG_POOL_2D_H_
 
 #include "Module.h"
+#include "Kernels/Pool.h"
 
 namespace StaticNet
 {
@@ -11,45 +12,64 @@ namespace StaticNet
         AvgPool2D() = delete;
     };
 
-    template <class T, size_t IDim, size_t ODim, size_t I>
-    class AvgPool2D<Tensor<T, I, IDim, IDim>, Tensor<T, I, ODim, ODim>> : public Module<T>
+    template <class T, size_t C, size_t IH, size_t IW, size_t OH, size_t OW, class Layout>
+    class AvgPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>, Layout> : public Module<T>
     {
-        static_assert(IDim % ODim == 0, "Output features must be a multiple of input features");
-        static constexpr size_t KDim = IDim/ODim;
+        static_assert(IH % OH == 0 && IW % OW == 0, "Input features must be a multiple of output features");
+        static constexpr size_t KH = IH / OH;
+        static constexpr size_t KW = IW / OW;
+        static constexpr size_t Block = Layout::template block<C>;
 
     public:
         AvgPool2D(Module<T> *parent) : Module<T>("AvgPool2D", parent) {};
 
         template <size_t Batch>
-        Tensor<T, Batch, I, ODim, ODim> forward(const Tensor<T, Batch, I, IDim, IDim> &input)
+        static constexpr ModuleCost cost()
         {
-            this->memory(AccessType::Write, input);
-            Tensor<T, Batch, I, ODim, ODim> result;
-            for (size_t i = 0; i < Batch; i++)
-                for (size_t j = 0; j < I; j++)
-                    result[i][j] = pool<T, IDim, ODim>(input[i][j], pool_func);
+            ModuleCost result;
+            result.forward_flops = Batch * C * (IH * IW + OH * OW);
+            result.backward_flops = Batch * C * IH * IW;
+            result.output_bytes = Batch * C * OH * OW * sizeof(T);
+            result.peak_bytes = result.output_bytes;
             return result;
         }
 
-        template <size_t Batch>
-        Tensor<T, Batch, I, IDim, IDim> backward(const Tensor<T, Batch, I, ODim, ODim> &nextDelta, float learningRate)
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, C, OH, OW> forward(const Tensor<T, Batch, D...> &input)
+        {
+            static_assert(is_layout_tensor_v<Layout, C, IH, IW, Tensor<T, Batch, D...>>, "AvgPool2D input does not match its layout");
+            STATICNET_PROFILE_MODULE(forward);
+            STATICNET_PROFILE_KERNEL("pool", Batch * C * IH * IW, sizeof(T) * Batch * C * (IH * IW + OH * OW));
+            LayoutTensor<Layout, T, Batch, C, OH, OW> result;
+            if constexpr (Block == 1)
+                Kernels::avg_pool2d(input.data, result.data, Batch * C, IH, IW, KH, KW, KH, KW);
+            else
+                Kernels::avg_pool2d_blocked(input.data, result.data, Batch * C / Block, IH, IW, Block, KH, KW, KH, KW);
+            return result;
+        }
+
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, C, IH, IW> backward(const Tensor<T, Batch, D...> &nextDelta, float learningRate)
         {
-            Tensor<T, Batch, I, IDim, IDim> delta;
-            for (size_t i = 0; i < Batch; i++)
-                for (size_t k = 0; k < I; k++) 
-                    delta[i][k] = unpool(nextDelta[i][k], unpool_func); 
-                    
+            static_assert(is_layout_tensor_v<Layout, C, OH, OW, Tensor<T, Batch, D...>>, "AvgPool2D gradient does not match its layout");
+            STATICNET_PROFILE_MODULE(backward);
+            STATICNET_PROFILE_KERNEL("unpool", Batch * C * IH * IW, sizeof(T) * Batch * C * (IH * IW + OH * OW));
+            LayoutTensor<Layout, T, Batch, C, IH, IW> delta;
+            if constexpr (Block == 1)
+                Kernels::avg_pool2d_backward(nextDelta.data, delta.data, Batch * C, IH, IW, KH, KW, KH, KW);
+            else
+                Kernels::avg_pool2d_blocked_backward(nextDelta.data, delta.data, Batch * C / Block, IH, IW, Block, KH, KW, KH, KW);
             return delta;
         }
+    };
 
-    private:
-        std::function<T(Tensor<T, KDim, KDim>)> pool_func = [](Tensor<T, KDim, KDim> input) {
-            return input.reduce().reduce() / (KDim * KDim);
-        };
-        std::function<Tensor<T, KDim, KDim>(T)> unpool_func = [](T input) {
-            return Tensor<T, KDim, KDim>(input / (KDim * KDim));
-        };
+    template <class T, size_t C, size_t IH, size_t IW, size_t OH, size_t OW>
+    class AvgPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>>
+        : public AvgPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>, NCHW>
+    {
+    public:
+        using AvgPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>, NCHW>::AvgPool2D;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
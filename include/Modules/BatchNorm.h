@@ -0,0 +1,224 @@
+#ifndef BATCHNORM_H_
+#define BATCHNORM_H_
+
+#include <cmath>
+
+#include "Module.h"
+#include "Kernels/BatchNorm.h"
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // Batch normalization, y = gamma * (x - mean) / sqrt(var + epsilon) + beta
+    // per channel.
+    //
+    // While training, mean and var are the statistics of the current batch
+    // and running estimates are updated with `momentum` once per step, not
+    // again when a Checkpoint recomputes the pass; after train(false)
+    // the running estimates are used instead. fold_into(layer) merges that
+    // inference-time affine into the Conv2D or Linear feeding this module,
+    // which then passes its input through untouched until train(true)
+    // restarts it as a fresh identity normalization on the folded layer.
+    // ------------------------------------------------------------------------
+
+    template <class T, size_t C, size_t Pixels, size_t Block>
+    class BatchNormBase : public Module<T>
+    {
+    public:
+        BatchNormBase(std::string name, Module<T> *parent) : Module<T>(name, parent, cost<1>().parameters) {}
+
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            constexpr size_t Size = Batch * C * Pixels;
+
+            ModuleCost result;
+            result.parameters = 2 * C;
+            result.parameter_bytes = result.parameters * sizeof(T);
+            result.forward_flops = 5 * Size;
+            result.backward_flops = 6 * Size + 2 * result.parameters;
+            result.cached_bytes = (Size + 2 * C) * sizeof(T);
+            result.output_bytes = Size * sizeof(T);
+            result.peak_bytes = result.cached_bytes + result.output_bytes;
+            return result;
+        }
+
+        void train(bool enabled) override
+        {
+            if (enabled && folded)
+            {
+                gamma = Tensor<T, C>(T(1));
+                beta = Tensor<T, C>();
+                running_mean = Tensor<T, C>();
+                running_var = Tensor<T, C>(T(1));
+                folded = false;
+            }
+            training = enabled;
+            Module<T>::train(enabled);
+        }
+
+        template <class Layer>
+        void fold_into(Layer &layer)
+        {
+            Tensor<T, C> scale, shift;
+            inference_affine(scale, shift);
+            layer.fold(scale, shift);
+            folded = true;
+        }
+
+        float momentum = 0.1f;
+        T epsilon = T(1e-5);
+
+        Tensor<T, C> running_mean;
+        Tensor<T, C> running_var = Tensor<T, C>(T(1));
+
+    protected:
+        // Per-channel statistics of the batch, saved for backward.
+        struct Statistics
+        {
+            T mean[C];
+            T inv_std[C];
+        };
+
+        template <size_t Batch, size_t... D>
+        Tensor<T, Batch, D...> normalize(const Tensor<T, Batch, D...> &input)
+        {
+            STATICNET_PROFILE_MODULE(forward);
+            Tensor<T, Batch, D...> result;
+            if (folded)
+            {
+                result = input;
+                return result;
+            }
+
+            Tensor<T, C> scale, shift;
+            if (!training)
+                inference_affine(scale, shift);
+            else
+            {
+                STATICNET_PROFILE_KERNEL("batchnorm_statistics", 3 * Batch * C * Pixels, sizeof(T) * Batch * C * Pixels);
+                Statistics statistics;
+                T *mean = statistics.mean, *inv_std = statistics.inv_std;
+                Kernels::batchnorm_statistics(input.data, mean, inv_std, Batch, C, Pixels, Block);
+
+                // A recomputed pass (see Checkpoint) sees the same batch again.
+                const T count = (T)(Batch * Pixels), unbiased = count > 1 ? count / (count - 1) : T(1);
+                const bool update = !this->recomputing();
+                for (size_t c = 0; c < C; c++)
+                {
+                    if (update)
+                    {
+                        running_mean[c] += (T)momentum * (mean[c] - running_mean[c]);
+                        running_var[c] += (T)momentum * (inv_std[c] * unbiased - running_var[c]);
+                    }
+                    inv_std[c] = T(1) / std::sqrt(inv_std[c] + epsilon);
+                    scale[c] = gamma[c] * inv_std[c];
+                    shift[c] = beta[c] - mean[c] * scale[c];
+                }
+
+                this->memory(AccessType::Write, input);
+                this->memory(AccessType::Write, statistics);
+            }
+
+            STATICNET_PROFILE_KERNEL("batchnorm_apply", 2 * Batch * C * Pixels, 2 * sizeof(T) * Batch * C * Pixels);
+            Kernels::batchnorm_apply(input.data, result.data, scale.data, shift.data, Batch, C, Pixels, Block);
+            return result;
+        }
+
+        template <size_t Batch, size_t... D>
+        Tensor<T, Batch, D...> normalize_backward(const Tensor<T, Batch, D...> &nextDelta, float learningRate)
+        {
+            STATICNET_PROFILE_MODULE(backward);
+            STATICNET_PROFILE_KERNEL("batchnorm_backward", cost<Batch>().backward_flops, 4 * sizeof(T) * Batch * C * Pixels);
+            const auto &input = this->template memory<Batch, D...>(AccessType::Read);
+            const auto &statistics = this->template memory<Statistics>(AccessType::Read);
+
+            Tensor<T, Batch, D...> delta;
+            Tensor<T, C> dgamma, dbeta;
+            Kernels::batchnorm_backward(input.data, nextDelta.data, statistics.mean, statistics.inv_std, gamma.data,
+                                        delta.data, dgamma.data, dbeta.data, Batch, C, Pixels, Block);
+
+            gamma -= dgamma * (learningRate / Batch);
+            beta -= dbeta * (learningRate / Batch);
+            return delta;
+        }
+
+        void inference_affine(Tensor<T, C> &scale, Tensor<T, C> &shift) const
+        {
+            for (size_t c = 0; c < C; c++)
+            {
+                scale[c] = gamma[c] / std::sqrt(running_var[c] + epsilon);
+                shift[c] = beta[c] - running_mean[c] * scale[c];
+            }
+        }
+
+        Tensor<T, C> gamma = Tensor<T, C>(T(1));
+        Tensor<T, C> beta;
+        bool training = true;
+        bool folded = false;
+    };
+
+    template <typename... T>
+    class BatchNorm1D
+    {
+        BatchNorm1D() = delete;
+    };
+
+    template <typename... T>
+    class BatchNorm2D
+    {
+        BatchNorm2D() = delete;
+    };
+
+    // BatchNorm1D<Tensor<T, C>> over [Batch, C] features, e.g. after Linear.
+    template <class T, size_t C>
+    class BatchNorm1D<Tensor<T, C>> : public BatchNormBase<T, C, 1, C>
+    {
+    public:
+        BatchNorm1D(Module<T> *parent) : BatchNormBase<T, C, 1, C>("BatchNorm1D", parent) {}
+
+        template <size_t Batch>
+        Tensor<T, Batch, C> forward(const Tensor<T, Batch, C> &input)
+        {
+            return this->normalize(input);
+        }
+
+        template <size_t Batch>
+        Tensor<T, Batch, C> backward(const Tensor<T, Batch, C> &nextDelta, float learningRate)
+        {
+            return this->normalize_backward(nextDelta, learningRate);
+        }
+    };
+
+    // BatchNorm2D<Tensor<T, C, H, W>, Layout> over a conv activation,
+    // statistics per channel across batch and pixels.
+    template <class T, size_t C, size_t H, size_t W, class Layout>
+    class BatchNorm2D<Tensor<T, C, H, W>, Layout> : public BatchNormBase<T, C, H * W, Layout::template block<C>>
+    {
+    public:
+        BatchNorm2D(Module<T> *parent) : BatchNormBase<T, C, H * W, Layout::template block<C>>("BatchNorm2D", parent) {}
+
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, C, H, W> forward(const Tensor<T, Batch, D...> &input)
+        {
+            static_assert(is_layout_tensor_v<Layout, C, H, W, Tensor<T, Batch, D...>>, "BatchNorm2D input does not match its layout");
+            return this->normalize(input);
+        }
+
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, C, H, W> backward(const Tensor<T, Batch, D...> &nextDelta, float learningRate)
+        {
+            static_assert(is_layout_tensor_v<Layout, C, H, W, Tensor<T, Batch, D...>>, "BatchNorm2D gradient does not match its layout");
+            return this->normalize_backward(nextDelta, learningRate);
+        }
+    };
+
+    template <class T, size_t C, size_t H, size_t W>
+    class BatchNorm2D<Tensor<T, C, H, W>> : public BatchNorm2D<Tensor<T, C, H, W>, NCHW>
+    {
+    public:
+        using BatchNorm2D<Tensor<T, C, H, W>, NCHW>::BatchNorm2D;
+    };
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include "Module.h"
+
+namespace StaticNet
+{
+    template <typename... T>
+    class Checkpoint
+    {
+        Checkpoint() = delete;
+    };
+
+    // ------------------------------------------------------------------------
+    // Activation checkpointing around a segment of the module tree.
+    //
+    // Checkpoint<Tensor<T, Input...>, Segment> runs Segment (any module built
+    // from a parent pointer, with forward/backward/cost templated on Batch)
+    // but keeps only the segment input alive between passes. The segment's
+    // own saved tensors are dropped in forward, recomputed by a second
+    // forward at the start of backward, and freed once its backward is done,
+    // so at most one checkpointed segment holds activations at a time. The
+    // second forward runs with recompute(true), so running statistics and
+    // similar state are only updated by the first.
+    // checkpoint(false) turns it back into a plain pass-through.
+    // ------------------------------------------------------------------------
+
+    template <class T, size_t... Input, class Segment>
+    class Checkpoint<Tensor<T, Input...>, Segment> : public Module<T>
+    {
+    public:
+        Checkpoint(Module<T> *parent) : Module<T>("Checkpoint", parent, Segment::template cost<1>().parameters), segment(this)
+        {
+            this->parameters = segment.parameters;
+        }
+
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            constexpr ModuleCost inner = Segment::template cost<Batch>();
+
+            ModuleCost result = inner;
+            result.backward_flops = inner.backward_flops + inner.forward_flops;
+            result.cached_bytes = Batch * (... * Input) * sizeof(T);
+            result.peak_bytes = result.cached_bytes + inner.peak_bytes;
+            return result;
+        }
+
+        void checkpoint(bool enabled) override
+        {
+            this->enabled = enabled;
+            Module<T>::checkpoint(enabled);
+        }
+
+        template <size_t Batch>
+        auto forward(const Tensor<T, Batch, Input...> &input)
+        {
+            STATICNET_PROFILE_MODULE(forward);
+            if (!enabled)
+                return segment.template forward<Batch>(input);
+
+            this->memory(AccessType::Write, input);
+            segment.record(false);
+            auto output = segment.template forward<Batch>(input);
+            segment.record(this->recording());
+            return output;
+        }
+
+        template <size_t Batch, size_t... D>
+        Tensor<T, Batch, Input...> backward(const Tensor<T, Batch, D...> &nextDelta, float learningRate)
+        {
+            STATICNET_PROFILE_MODULE(backward);
+            if (!enabled)
+                return segment.template backward<Batch>(nextDelta, learningRate);
+
+            segment.recompute(true);
+            segment.template forward<Batch>(this->template memory<Batch, Input...>(AccessType::Read));
+            segment.recompute(false);
+            auto delta = segment.template backward<Batch>(nextDelta, learningRate);
+            this->release();
+            return delta;
+        }
+
+        Segment segment;
+
+    private:
+        bool enabled = true;
+    };
+}
+
+#endif
@@ -11,60 +11,144 @@ namespace StaticNet
         Conv2D() = delete;
     };
 
-    template <class T, size_t IDim, size_t ODim, size_t C, size_t FN>
-    class Conv2D<Tensor<T, C, IDim, IDim>, Tensor<T, FN, ODim, ODim>>
+    // Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<KH, KW, SH, SW, PH, PW, DH, DW>, Layout>
+    //
+    // The output shape must match the window; padding is applied inside
+    // im2col. Weights are stored as the [C * KH * KW, FN] GEMM operand. With a
+    // channel-last layout the GEMM output already is the NHWC activation, so
+    // neither direction transposes.
+    template <class T, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW, class Window, class Layout>
+    class Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window, Layout>
         : public Module<T>
     {
-        static constexpr size_t KDim = IDim - ODim + 1;
+        static_assert(Window::output_h(IH) == OH && Window::output_w(IW) == OW, "Conv2D output shape does not match its window");
+
+        static constexpr size_t Patch = C * Window::kh * Window::kw;
+        static constexpr size_t Pixels = OH * OW;
+        static constexpr size_t InBlock = Layout::template block<C>;
+        static constexpr size_t OutBlock = Layout::template block<FN>;
 
     public:
-        Conv2D(Module<T> *parent) : Module<T>("Conv2D", parent, KDim * KDim + ODim * ODim){};
+        Conv2D(Module<T> *parent) : Module<T>("Conv2D", parent, cost<1>().parameters){};
+        ~Conv2D() { this->wait_update(); }
 
         template <size_t Batch>
-        Tensor<T, Batch, FN, ODim, ODim> forward(const Tensor<T, Batch, C, IDim, IDim> &input)
+        static constexpr ModuleCost cost()
         {
-            auto col = im2col<KDim>(input);
-            this->memory(AccessType::Write, col);
-            auto kernel_reshaped = kernel.template reshape_ref<FN, C * KDim * KDim>();
-            Tensor<T, Batch, FN, ODim, ODim> result = dot(col, kernel_reshaped.template transpose<1, 0>())
-                                                          .template reshape<Batch, FN, ODim, ODim>();
-            for (size_t i = 0; i < Batch; i++)
-                for (size_t j = 0; j < FN; j++)
-                    for (size_t k = 0; k < ODim; k++)
-                        for (size_t l = 0; l < ODim; l++)
-                            result[i][j][k][l] += biases[j][0][0];
+            constexpr size_t Rows = Batch * Pixels;
 
+            ModuleCost result;
+            result.parameters = FN * Patch + FN;
+            result.parameter_bytes = result.parameters * sizeof(T);
+            result.forward_flops = 2 * Rows * Patch * FN + Rows * FN;
+            result.backward_flops = 4 * Rows * Patch * FN + Rows * Patch + Rows * FN + 2 * result.parameters;
+            result.cached_bytes = Rows * Patch * sizeof(T);
+            result.output_bytes = Rows * FN * sizeof(T);
+            result.peak_bytes = 2 * result.cached_bytes + result.output_bytes;
             return result;
         }
 
-        template <size_t Batch>
-        Tensor<T, Batch, C, IDim, IDim> backward(const Tensor<T, Batch, FN, ODim, ODim> &dout, float learningRate)
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, FN, OH, OW> forward(const Tensor<T, Batch, D...> &input)
+        {
+            static_assert(is_layout_tensor_v<Layout, C, IH, IW, Tensor<T, Batch, D...>>, "Conv2D input does not match its layout");
+            STATICNET_PROFILE_MODULE(forward);
+            constexpr Kernels::Conv2DGeometry geometry = Window::geometry(C, IH, IW);
+            this->wait_update();
+
+            Tensor<T, Batch * Pixels, Patch> col;
+            {
+                STATICNET_PROFILE_KERNEL("im2col", 0, sizeof(T) * (Batch * C * IH * IW + Batch * Pixels * Patch));
+                if constexpr (InBlock == 1)
+                    Kernels::im2col(input.data, col.data, Batch, geometry);
+                else
+                    Kernels::im2col_blocked(input.data, col.data, Batch, geometry, InBlock);
+            }
+            this->memory(AccessType::Write, col);
+            auto rows = dot(col, kernel);
+
+            if constexpr (OutBlock == FN)
+            {
+                rows += biases;
+                LayoutTensor<Layout, T, Batch, FN, OH, OW> result(rows);
+                return result;
+            }
+            else
+            {
+                LayoutTensor<Layout, T, Batch, FN, OH, OW> result;
+                Kernels::reorder_blocked(rows.data, result.data, Batch, FN, Pixels, FN, OutBlock, biases.data);
+                return result;
+            }
+        }
+
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, C, IH, IW> backward(const Tensor<T, Batch, D...> &dout, float learningRate)
         {
-            auto db_pre = dout.reduce();
-            Tensor<T, FN, 1, 1> db;
-            for (size_t i = 0; i < FN; i++)
-                db[i][0][0] = db_pre[i].reduce().reduce();
+            static_assert(is_layout_tensor_v<Layout, FN, OH, OW, Tensor<T, Batch, D...>>, "Conv2D gradient does not match its layout");
+            STATICNET_PROFILE_MODULE(backward);
+            constexpr Kernels::Conv2DGeometry geometry = Window::geometry(C, IH, IW);
+            this->wait_update();
 
-            auto dout_reshaped = dout.template transpose<1, 2, 3, 0>().template reshape<FN, Batch * ODim * ODim>();
-            auto input_transposed = this->memory<Batch * ODim * ODim, C * KDim * KDim>(AccessType::Read);
+            Tensor<T, Batch * Pixels, FN> dout_rows;
+            Kernels::reorder_blocked(dout.data, dout_rows.data, Batch, FN, Pixels, OutBlock, FN);
+            Tensor<T, FN> db;
+            reduce_sum<0>(dout_rows, db);
 
-            auto dw_pre = dot(dout_reshaped, input_transposed);
-            auto dw = dw_pre.template reshape<FN, C, KDim, KDim>();
+            const auto &col = this->template memory<Batch * Pixels, Patch>(AccessType::Read);
+            auto dcol = dot_nt(dout_rows, kernel);
 
-            auto w_reshaped = kernel.template reshape_ref<FN, C * KDim * KDim>();
-            auto dx_col = dot(w_reshaped.template transpose<1, 0>(), dout_reshaped);
-            auto dx = col2im<float, KDim, Batch, C, IDim>(dx_col);
+            LayoutTensor<Layout, T, Batch, C, IH, IW> dx;
+            {
+                STATICNET_PROFILE_KERNEL("col2im", Batch * Pixels * Patch, sizeof(T) * (Batch * C * IH * IW + Batch * Pixels * Patch));
+                if constexpr (InBlock == 1)
+                    Kernels::col2im(dcol.data, dx.data, Batch, geometry);
+                else
+                    Kernels::col2im_blocked(dcol.data, dx.data, Batch, geometry, InBlock);
+            }
 
-            kernel -= dw / (float)Batch * learningRate;
-            biases -= db / (float)Batch * learningRate;
+            // The weight step is the epilogue of dW = col^T dout, applied in
+            // place. col stays put until the next forward, which waits for
+            // the step; dout_rows and db are handed over to it.
+            this->update([this, &col, rows = dout_rows, db = db, learningRate]() {
+                STATICNET_PROFILE_KERNEL("dot", 2 * Batch * Pixels * Patch * FN, sizeof(T) * (Batch * Pixels * (Patch + FN) + Patch * FN));
+                Kernels::gemm_tn(col.data, rows.data, kernel.data, Patch, Batch * Pixels, FN, (T)(-learningRate / Batch), T(1));
+                biases -= db / (T)Batch * learningRate;
+            });
 
             return dx;
         }
 
+        // Folds a per-channel affine of the output, y * scale + shift, into
+        // the kernel and biases (see BatchNorm2D::fold_into).
+        void fold(const Tensor<T, FN> &scale, const Tensor<T, FN> &shift)
+        {
+            this->wait_update();
+            kernel *= scale;
+            biases *= scale;
+            biases += shift;
+        }
+
     private:
-        Tensor<T, FN, C, KDim, KDim> kernel = Tensor<T, FN, C, KDim, KDim>::random();
-        Tensor<T, FN, 1, 1> biases = Tensor<T, FN, 1, 1>::random();
+        Tensor<T, Patch, FN> kernel = Tensor<T, Patch, FN>::random();
+        Tensor<T, FN> biases = Tensor<T, FN>::random();
+    };
+
+    template <class T, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW, class Window>
+    class Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window>
+        : public Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window, NCHW>
+    {
+    public:
+        using Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window, NCHW>::Conv2D;
+    };
+
+    // Stride 1, no padding: the window is whatever maps IH x IW onto OH x OW.
+    template <class T, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW>
+    class Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>>
+        : public Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<IH - OH + 1, IW - OW + 1>, NCHW>
+    {
+    public:
+        using Conv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<IH - OH + 1, IW - OW + 1>, NCHW>::Conv2D;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
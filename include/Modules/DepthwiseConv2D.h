@@ -0,0 +1,96 @@
+#ifndef DEPTHWISE_CONV2D_H_
+#define DEPTHWISE_CONV2D_H_
+
+#include "Module.h"
+#include "Kernels/DepthwiseConv.h"
+
+namespace StaticNet
+{
+    template <typename... T>
+    class DepthwiseConv2D
+    {
+        DepthwiseConv2D() = delete;
+    };
+
+    // DepthwiseConv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<...>>
+    //
+    // Each input channel is filtered on its own by FN / C filters (the
+    // depth multiplier); output channel f reads input channel f / (FN / C).
+    template <class T, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW, class Window>
+    class DepthwiseConv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window>
+        : public Module<T>
+    {
+        static_assert(FN % C == 0, "DepthwiseConv2D output channels must be a multiple of input channels");
+        static_assert(Window::output_h(IH) == OH && Window::output_w(IW) == OW, "DepthwiseConv2D output shape does not match its window");
+
+        static constexpr size_t Multiplier = FN / C;
+        static constexpr size_t Taps = Window::kh * Window::kw;
+
+    public:
+        DepthwiseConv2D(Module<T> *parent) : Module<T>("DepthwiseConv2D", parent, cost<1>().parameters){};
+
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            constexpr size_t Outputs = Batch * FN * OH * OW;
+
+            ModuleCost result;
+            result.parameters = FN * Taps + FN;
+            result.parameter_bytes = result.parameters * sizeof(T);
+            result.forward_flops = 2 * Outputs * Taps + Outputs;
+            result.backward_flops = 4 * Outputs * Taps + Outputs + 2 * result.parameters;
+            result.cached_bytes = Batch * C * IH * IW * sizeof(T);
+            result.output_bytes = Outputs * sizeof(T);
+            result.peak_bytes = result.cached_bytes + result.output_bytes;
+            return result;
+        }
+
+        template <size_t Batch>
+        Tensor<T, Batch, FN, OH, OW> forward(const Tensor<T, Batch, C, IH, IW> &input)
+        {
+            STATICNET_PROFILE_MODULE(forward);
+            STATICNET_PROFILE_KERNEL("depthwise_conv2d", cost<Batch>().forward_flops, sizeof(T) * (Batch * (C * IH * IW + FN * OH * OW)));
+            this->memory(AccessType::Write, input);
+
+            Tensor<T, Batch, FN, OH, OW> result;
+            Kernels::depthwise_conv2d(input.data, kernel.data, biases.data, result.data,
+                                      Batch, Multiplier, Window::geometry(C, IH, IW));
+            return result;
+        }
+
+        template <size_t Batch>
+        Tensor<T, Batch, C, IH, IW> backward(const Tensor<T, Batch, FN, OH, OW> &dout, float learningRate)
+        {
+            STATICNET_PROFILE_MODULE(backward);
+            STATICNET_PROFILE_KERNEL("depthwise_conv2d_backward", cost<Batch>().backward_flops, sizeof(T) * (Batch * (2 * C * IH * IW + FN * OH * OW)));
+            const auto &input = this->template memory<Batch, C, IH, IW>(AccessType::Read);
+            constexpr Kernels::Conv2DGeometry geometry = Window::geometry(C, IH, IW);
+
+            Tensor<T, FN, Window::kh, Window::kw> dw;
+            Tensor<T, FN> db;
+            Kernels::depthwise_conv2d_backward_weights(input.data, dout.data, dw.data, db.data, Batch, Multiplier, geometry);
+
+            Tensor<T, Batch, C, IH, IW> dx;
+            Kernels::depthwise_conv2d_backward_data(dout.data, kernel.data, dx.data, Batch, Multiplier, geometry);
+
+            kernel -= dw / (T)Batch * learningRate;
+            biases -= db / (T)Batch * learningRate;
+
+            return dx;
+        }
+
+    private:
+        Tensor<T, FN, Window::kh, Window::kw> kernel = Tensor<T, FN, Window::kh, Window::kw>::random();
+        Tensor<T, FN> biases = Tensor<T, FN>::random();
+    };
+
+    template <class T, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW>
+    class DepthwiseConv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>>
+        : public DepthwiseConv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<IH - OH + 1, IW - OW + 1>>
+    {
+    public:
+        using DepthwiseConv2D<Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<IH - OH + 1, IW - OW + 1>>::DepthwiseConv2D;
+    };
+}
+
+#endif
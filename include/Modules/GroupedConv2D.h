@@ -0,0 +1,136 @@
+#ifndef GROUPED_CONV2D_H_
+#define GROUPED_CONV2D_H_
+
+#include "Module.h"
+
+namespace StaticNet
+{
+    template <size_t Groups, typename... T>
+    class GroupedConv2D
+    {
+        GroupedConv2D() = delete;
+    };
+
+    // GroupedConv2D<Groups, Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<...>>
+    //
+    // Input and output channels are split into Groups contiguous blocks and
+    // block g of the output only sees block g of the input. Each group is an
+    // im2col over its channel range followed by a [Batch * OH * OW, C / Groups * KH * KW]
+    // x [C / Groups * KH * KW, FN / Groups] product, all groups in one batched_dot.
+    template <size_t Groups, class T, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW, class Window>
+    class GroupedConv2D<Groups, Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window>
+        : public Module<T>
+    {
+        static_assert(C % Groups == 0 && FN % Groups == 0, "GroupedConv2D channels must divide into groups");
+        static_assert(Window::output_h(IH) == OH && Window::output_w(IW) == OW, "GroupedConv2D output shape does not match its window");
+
+        static constexpr size_t GroupC = C / Groups;
+        static constexpr size_t GroupFN = FN / Groups;
+        static constexpr size_t Patch = GroupC * Window::kh * Window::kw;
+        static constexpr size_t Pixels = OH * OW;
+
+    public:
+        GroupedConv2D(Module<T> *parent) : Module<T>("GroupedConv2D", parent, cost<1>().parameters){};
+
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            constexpr size_t Rows = Batch * Pixels;
+
+            ModuleCost result;
+            result.parameters = FN * Patch + FN;
+            result.parameter_bytes = result.parameters * sizeof(T);
+            result.forward_flops = 2 * Rows * Patch * FN + Rows * FN;
+            result.backward_flops = 4 * Rows * Patch * FN + Rows * Patch * Groups + Rows * FN + 2 * result.parameters;
+            result.cached_bytes = Groups * Rows * Patch * sizeof(T);
+            result.output_bytes = Rows * FN * sizeof(T);
+            result.peak_bytes = 2 * result.cached_bytes + result.output_bytes;
+            return result;
+        }
+
+        template <size_t Batch>
+        Tensor<T, Batch, FN, OH, OW> forward(const Tensor<T, Batch, C, IH, IW> &input)
+        {
+            STATICNET_PROFILE_MODULE(forward);
+            constexpr Kernels::Conv2DGeometry geometry = Window::geometry(GroupC, IH, IW);
+
+            Tensor<T, Groups, Batch * Pixels, Patch> col;
+            {
+                STATICNET_PROFILE_KERNEL("im2col", 0, sizeof(T) * (Batch * C * IH * IW + Groups * Batch * Pixels * Patch));
+                for (size_t g = 0; g < Groups; g++)
+                    Kernels::im2col(input.data + g * GroupC * IH * IW, col.data + g * Batch * Pixels * Patch,
+                                    Batch, geometry, C * IH * IW);
+            }
+            this->memory(AccessType::Write, col);
+
+            auto rows = batched_dot(col, kernel);
+
+            Tensor<T, Batch, FN, OH, OW> result;
+#pragma omp parallel for if (Batch * Pixels * FN >= Kernels::ParallelThreshold)
+            for (long p = 0; p < (long)(Batch * FN); p++)
+            {
+                const size_t b = p / FN, g = p % FN / GroupFN, f = p % GroupFN;
+                const T *src = rows.data + (g * Batch + b) * Pixels * GroupFN + f;
+                T *dst = result.data + p * Pixels;
+                for (size_t i = 0; i < Pixels; i++)
+                    dst[i] = src[i * GroupFN] + biases.data[g * GroupFN + f];
+            }
+
+            return result;
+        }
+
+        template <size_t Batch>
+        Tensor<T, Batch, C, IH, IW> backward(const Tensor<T, Batch, FN, OH, OW> &dout, float learningRate)
+        {
+            STATICNET_PROFILE_MODULE(backward);
+            constexpr Kernels::Conv2DGeometry geometry = Window::geometry(GroupC, IH, IW);
+
+            Tensor<T, FN> db;
+            reduce_sum_except<1>(dout, db);
+
+            const auto &col = this->template memory<Groups, Batch * Pixels, Patch>(AccessType::Read);
+            Tensor<T, Groups, Batch * Pixels, GroupFN> dout_rows;
+#pragma omp parallel for if (Batch * Pixels * FN >= Kernels::ParallelThreshold)
+            for (long p = 0; p < (long)(Batch * FN); p++)
+            {
+                const size_t b = p / FN, g = p % FN / GroupFN, f = p % GroupFN;
+                const T *src = dout.data + p * Pixels;
+                T *dst = dout_rows.data + (g * Batch + b) * Pixels * GroupFN + f;
+                for (size_t i = 0; i < Pixels; i++)
+                    dst[i * GroupFN] = src[i];
+            }
+
+            auto dcol = batched_dot_nt(dout_rows, kernel);
+            {
+                STATICNET_PROFILE_KERNEL("batched_dot", 2 * Batch * Pixels * Patch * FN, sizeof(T) * (Groups * Batch * Pixels * Patch + Batch * Pixels * FN + Patch * FN));
+                Kernels::batched_gemm_tn(col.data, Batch * Pixels * Patch, dout_rows.data, Batch * Pixels * GroupFN, kernel.data, Patch * GroupFN,
+                                         Groups, Patch, Batch * Pixels, GroupFN, (T)(-learningRate / Batch), T(1));
+            }
+
+            Tensor<T, Batch, C, IH, IW> dx;
+            {
+                STATICNET_PROFILE_KERNEL("col2im", Groups * Batch * Pixels * Patch, sizeof(T) * (Batch * C * IH * IW + Groups * Batch * Pixels * Patch));
+                for (size_t g = 0; g < Groups; g++)
+                    Kernels::col2im(dcol.data + g * Batch * Pixels * Patch, dx.data + g * GroupC * IH * IW, Batch, geometry, C * IH * IW);
+            }
+
+            biases -= db / (T)Batch * learningRate;
+
+            return dx;
+        }
+
+    private:
+        Tensor<T, Groups, Patch, GroupFN> kernel = Tensor<T, Groups, Patch, GroupFN>::random();
+        Tensor<T, FN> biases = Tensor<T, FN>::random();
+    };
+
+    template <size_t Groups, class T, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW>
+    class GroupedConv2D<Groups, Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>>
+        : public GroupedConv2D<Groups, Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<IH - OH + 1, IW - OW + 1>>
+    {
+    public:
+        using GroupedConv2D<Groups, Tensor<T, C, IH, IW>, Tensor<T, FN, OH, OW>, Window2D<IH - OH + 1, IW - OW + 1>>::GroupedConv2D;
+    };
+}
+
+#endif
@@ -15,16 +15,31 @@ namespace StaticNet
     class Linear<Tensor<T, Input>, Tensor<T, Output>> : public Module<T>
     {
     public:
-        Linear(Module<T> *parent) : Module<T>("Linear", parent, (Input) * (Output + 1)) {};
-        ~Linear() {}
+        Linear(Module<T> *parent) : Module<T>("Linear", parent, cost<1>().parameters) {};
+        ~Linear() { this->wait_update(); }
+
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            ModuleCost result;
+            result.parameters = Input * Output + Output;
+            result.parameter_bytes = result.parameters * sizeof(T);
+            result.forward_flops = 2 * Batch * Input * Output + Batch * Output;
+            result.backward_flops = 4 * Batch * Input * Output + Batch * Output + 2 * result.parameters;
+            result.cached_bytes = Batch * Input * sizeof(T);
+            result.output_bytes = Batch * Output * sizeof(T);
+            result.peak_bytes = result.cached_bytes + result.output_bytes;
+            return result;
+        }
 
         template <size_t Batch>
         Tensor<T, Batch, Output> forward(const Tensor<T, Batch, Input> &input)
         {
+            STATICNET_PROFILE_MODULE(forward);
+            this->wait_update();
             this->template memory<Batch, Input>(AccessType::Write, input);
             auto result = dot(input, weights);
-            for (size_t i = 0; i < Batch; i++)
-                result[i] += biases;
+            result += biases;
 
             return result;
         }
@@ -32,13 +47,39 @@ namespace StaticNet
         template <size_t Batch>
         Tensor<T, Batch, Input> backward(const Tensor<T, Batch, Output> &nextDelta, float learningRate)
         {
-            Tensor<T, Input, Batch> input = this->template memory<Batch, Input>(AccessType::Read).template transpose<1, 0>();
+            STATICNET_PROFILE_MODULE(backward);
+            this->wait_update();
+            const auto &input = this->template memory<Batch, Input>(AccessType::Read);
+            const T rate = (T)(learningRate / Batch);
+
+            Tensor<T, Batch, Input> delta;
+            if (!this->overlapping)
+            {
+                STATICNET_PROFILE_KERNEL("linear_backward", cost<Batch>().backward_flops, sizeof(T) * (2 * Batch * Input + Batch * Output + 2 * Input * Output));
+                Kernels::linear_backward(input.data, nextDelta.data, weights.data, biases.data, delta.data,
+                                         Batch, Input, Output, rate);
+                return delta;
+            }
 
-            weights -= (dot(input, nextDelta) / (float)Batch) * learningRate;
-            biases -= (nextDelta.reduce() / (float)Batch) * learningRate;
+            // Unfused: dx first, then the step as a task that owns a copy of dy.
+            Kernels::gemm_nt(nextDelta.data, weights.data, delta.data, Batch, Output, Input);
+            this->update([this, &input, dy = Tensor<T, Batch, Output>(nextDelta), rate]() {
+                Tensor<T, Output> db;
+                reduce_sum<0>(dy, db);
+                Kernels::gemm_tn(input.data, dy.data, weights.data, Input, Batch, Output, -rate, T(1));
+                biases -= db * rate;
+            });
+            return delta;
+        }
 
-            return dot(nextDelta, weights.template transpose<1, 0>());
-            return Tensor<T, Batch, Input>();
+        // Folds a per-feature affine of the output, y * scale + shift, into
+        // the weights and biases (see BatchNorm1D::fold_into).
+        void fold(const Tensor<T, Output> &scale, const Tensor<T, Output> &shift)
+        {
+            this->wait_update();
+            weights *= scale;
+            biases *= scale;
+            biases += shift;
         }
 
     private:
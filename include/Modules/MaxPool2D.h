@@ -0,0 +1,79 @@
+#ifndef MAX_POOL_2D_H_
+#define MAX_POOL_2D_H_
+
+#include "Module.h"
+#include "Kernels/Pool.h"
+
+namespace StaticNet
+{
+    template <typename... T>
+    class MaxPool2D
+    {
+        MaxPool2D() = delete;
+    };
+
+    template <class T, size_t C, size_t IH, size_t IW, size_t OH, size_t OW, class Layout>
+    class MaxPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>, Layout> : public Module<T>
+    {
+        static_assert(IH % OH == 0 && IW % OW == 0, "Input features must be a multiple of output features");
+        static constexpr size_t KH = IH / OH;
+        static constexpr size_t KW = IW / OW;
+        static constexpr size_t Block = Layout::template block<C>;
+
+    public:
+        MaxPool2D(Module<T> *parent) : Module<T>("MaxPool2D", parent) {};
+
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            ModuleCost result;
+            result.forward_flops = Batch * C * IH * IW;
+            result.backward_flops = Batch * C * OH * OW;
+            result.cached_bytes = Batch * C * OH * OW * sizeof(uint32_t);
+            result.output_bytes = Batch * C * OH * OW * sizeof(T);
+            result.peak_bytes = result.cached_bytes + result.output_bytes;
+            return result;
+        }
+
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, C, OH, OW> forward(const Tensor<T, Batch, D...> &input)
+        {
+            static_assert(is_layout_tensor_v<Layout, C, IH, IW, Tensor<T, Batch, D...>>, "MaxPool2D input does not match its layout");
+            STATICNET_PROFILE_MODULE(forward);
+            STATICNET_PROFILE_KERNEL("max_pool", Batch * C * IH * IW, sizeof(T) * Batch * C * (IH * IW + 2 * OH * OW));
+            LayoutTensor<Layout, T, Batch, C, OH, OW> result;
+            Tensor<uint32_t, Batch, C, OH, OW> mask;
+            if constexpr (Block == 1)
+                Kernels::max_pool2d(input.data, result.data, mask.data, Batch * C, IH, IW, KH, KW, KH, KW);
+            else
+                Kernels::max_pool2d_blocked(input.data, result.data, mask.data, Batch * C / Block, IH, IW, Block, KH, KW, KH, KW);
+            this->memory(AccessType::Write, mask);
+            return result;
+        }
+
+        template <size_t Batch, size_t... D>
+        LayoutTensor<Layout, T, Batch, C, IH, IW> backward(const Tensor<T, Batch, D...> &nextDelta, float /* learningRate */)
+        {
+            static_assert(is_layout_tensor_v<Layout, C, OH, OW, Tensor<T, Batch, D...>>, "MaxPool2D gradient does not match its layout");
+            STATICNET_PROFILE_MODULE(backward);
+            STATICNET_PROFILE_KERNEL("max_unpool", Batch * C * OH * OW, sizeof(T) * Batch * C * (IH * IW + 2 * OH * OW));
+            const auto &mask = this->template memory<uint32_t, Batch, C, OH, OW>(AccessType::Read);
+            LayoutTensor<Layout, T, Batch, C, IH, IW> delta;
+            if constexpr (Block == 1)
+                Kernels::max_pool2d_backward(nextDelta.data, mask.data, delta.data, Batch * C, IH, IW, KH, KW, KH, KW);
+            else
+                Kernels::max_pool2d_blocked_backward(nextDelta.data, mask.data, delta.data, Batch * C / Block, IH, IW, Block, KH, KW, KH, KW);
+            return delta;
+        }
+    };
+
+    template <class T, size_t C, size_t IH, size_t IW, size_t OH, size_t OW>
+    class MaxPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>>
+        : public MaxPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>, NCHW>
+    {
+    public:
+        using MaxPool2D<Tensor<T, C, IH, IW>, Tensor<T, C, OH, OW>, NCHW>::MaxPool2D;
+    };
+}
+
+#endif
@@ -19,15 +19,31 @@ namespace StaticNet
         ReLU(Module<T> *parent) : Module<T>("ReLU", parent) {}
         ~ReLU() {}
 
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            constexpr size_t Size = Batch * (... * Input);
+
+            ModuleCost result;
+            result.forward_flops = Size;
+            result.backward_flops = 2 * Size;
+            result.cached_bytes = Size * sizeof(T);
+            result.output_bytes = Size * sizeof(T);
+            result.peak_bytes = result.cached_bytes + result.output_bytes;
+            return result;
+        }
+
         template <size_t Batch>
         Tensor<T, Batch, Input...> forward(const Tensor<T, Batch, Input...> &input) {
+            STATICNET_PROFILE_MODULE(forward);
             this->memory(AccessType::Write, input);
             return input.map(relu);
         }
 
         template <size_t Batch>
         Tensor<T, Batch, Input...> backward(const Tensor<T, Batch, Input...> &delta, float learningRate) {
-            Tensor<T, Batch, Input...> input = this->memory(AccessType::Read, Tensor<T, Batch, Input...>());
+            STATICNET_PROFILE_MODULE(backward);
+            const auto &input = this->template memory<Batch, Input...>(AccessType::Read);
             return hadamard(input.map(relu_grad), delta);
         }
 
@@ -0,0 +1,84 @@
+#ifndef SEQUENTIAL_H_
+#define SEQUENTIAL_H_
+
+#include <tuple>
+
+#include "Module.h"
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // A chain of modules run back to back, e.g.
+    //
+    //   Sequential<float, Linear<...>, ReLU<...>, Linear<...>> block(parent);
+    //
+    // Every layer is built in place with the Sequential as its parent and
+    // must accept the previous layer's output batch. The chain is itself a
+    // module, so it can be nested, checkpointed or used as a pipeline stage.
+    // ------------------------------------------------------------------------
+
+    template <class T, class... Layers>
+    class Sequential : public Module<T>
+    {
+        static_assert(sizeof...(Layers) > 0, "Sequential needs at least one layer");
+        static constexpr size_t Count = sizeof...(Layers);
+
+    public:
+        Sequential(Module<T> *parent = nullptr)
+            : Module<T>("Sequential", parent, cost<1>().parameters), layers(((void)sizeof(Layers *), this)...)
+        {
+            this->parameters = cost<1>().parameters;
+        }
+
+        template <size_t Batch>
+        static constexpr ModuleCost cost()
+        {
+            return (... + Layers::template cost<Batch>());
+        }
+
+        template <size_t I>
+        auto &layer()
+        {
+            return std::get<I>(layers);
+        }
+
+        template <size_t Batch, size_t... D>
+        auto forward(const Tensor<T, Batch, D...> &input)
+        {
+            STATICNET_PROFILE_MODULE(forward);
+            return forward_from<0, Batch>(input);
+        }
+
+        template <size_t Batch, size_t... D>
+        auto backward(const Tensor<T, Batch, D...> &nextDelta, float learningRate)
+        {
+            STATICNET_PROFILE_MODULE(backward);
+            return backward_from<Count - 1, Batch>(nextDelta, learningRate);
+        }
+
+    private:
+        template <size_t I, size_t Batch, class X>
+        auto forward_from(const X &x)
+        {
+            auto y = std::get<I>(layers).template forward<Batch>(x);
+            if constexpr (I + 1 == Count)
+                return y;
+            else
+                return forward_from<I + 1, Batch>(y);
+        }
+
+        template <size_t I, size_t Batch, class X>
+        auto backward_from(const X &delta, float learningRate)
+        {
+            auto d = std::get<I>(layers).template backward<Batch>(delta, learningRate);
+            if constexpr (I == 0)
+                return d;
+            else
+                return backward_from<I - 1, Batch>(d, learningRate);
+        }
+
+        std::tuple<Layers...> layers;
+    };
+}
+
+#endif
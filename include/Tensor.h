@@ -1,6 +1,7 @@
 #ifndef TENSOR_H_
 #define TENSOR_H_
 
+#include <algorithm>
 #include <functional>
 #include <initializer_list>
 #include <type_traits>
@@ -11,7 +12,16 @@
 #include <cassert>
 #include <array>
 
+#include "Kernels/Broadcast.h"
+#include "Kernels/Elementwise.h"
+#include "Kernels/Gemm.h"
+#include "Kernels/Im2Col.h"
+#include "Kernels/Permute.h"
+#include "Kernels/Reduce.h"
+#include "Kernels/Small.h"
+#include "Utils/Numa.h"
 #include "Utils/Random.h"
+#include "Utils/Profiler.h"
 
 namespace StaticNet
 {
@@ -30,6 +40,27 @@ namespace StaticNet
             return (... * Dims);
         }
 
+        template <class T>
+        T *allocate(size_t size)
+        {
+#ifdef STATICNET_PROFILE
+            Profiler::count_allocation(size * sizeof(T));
+#endif
+            T *data = new T[size];
+            Numa::place(data, size * sizeof(T));
+            return data;
+        }
+
+        // Fills with the same static OpenMP schedule the kernels use, so
+        // first-touch places large buffers next to the threads consuming them.
+        template <class T>
+        void fill(T *data, size_t size, const T &value)
+        {
+#pragma omp parallel for schedule(static) if (size >= Kernels::ParallelThreshold)
+            for (long i = 0; i < (long)size; i++)
+                data[i] = value;
+        }
+
         template <size_t R, size_t i, size_t Dim, size_t... Dims>
         constexpr size_t get_size_limit()
         {
@@ -52,6 +83,138 @@ namespace StaticNet
             return sizeof...(Dims);
         }
 
+        // Product of dims[begin, end).
+        template <size_t N>
+        constexpr size_t get_size_range(const std::array<size_t, N> &dims, size_t begin, size_t end)
+        {
+            size_t size = 1;
+            for (size_t i = begin; i < end; i++)
+                size *= dims[i];
+            return size;
+        }
+
+        template <class T, size_t Axis, class Seq, size_t... Dims>
+        struct remove_axis_helper;
+
+        template <class T, size_t Axis, size_t... I, size_t... Dims>
+        struct remove_axis_helper<T, Axis, std::index_sequence<I...>, Dims...>
+        {
+            static constexpr std::array<size_t, sizeof...(Dims)> dims = {Dims...};
+            typedef Tensor<T, dims[I < Axis ? I : I + 1]...> type;
+        };
+
+        template <class T, size_t Axis, size_t... Dims>
+        struct remove_axis
+        {
+            static_assert(Axis < sizeof...(Dims), "Reduction axis is out of range");
+            typedef typename remove_axis_helper<T, Axis, std::make_index_sequence<sizeof...(Dims) - 1>, Dims...>::type type;
+        };
+
+        template <class T, size_t Axis, size_t Dim>
+        struct remove_axis<T, Axis, Dim>
+        {
+            static_assert(Axis == 0, "Reduction axis is out of range");
+            typedef T type;
+        };
+
+        // NumPy broadcasting of two static shapes, aligned on the last axis:
+        // each pair of dims must match or one of them be 1 (or missing).
+        template <size_t Rank, size_t... Dims>
+        constexpr std::array<size_t, Rank> pad_dims()
+        {
+            constexpr std::array<size_t, sizeof...(Dims)> dims = {Dims...};
+            std::array<size_t, Rank> result{};
+            for (size_t i = 0; i < Rank; i++)
+                result[i] = i + sizeof...(Dims) < Rank ? 1 : dims[i + sizeof...(Dims) - Rank];
+            return result;
+        }
+
+        // Element strides of a dense tensor of `dims`, 0 along size-1 dims.
+        template <size_t Rank>
+        constexpr std::array<size_t, Rank> broadcast_strides(const std::array<size_t, Rank> &dims)
+        {
+            std::array<size_t, Rank> result{};
+            size_t stride = 1;
+            for (size_t i = Rank; i-- > 0;)
+            {
+                result[i] = dims[i] == 1 ? 0 : stride;
+                stride *= dims[i];
+            }
+            return result;
+        }
+
+        template <class A, class B>
+        struct broadcast_shape;
+
+        template <size_t... A, size_t... B>
+        struct broadcast_shape<std::index_sequence<A...>, std::index_sequence<B...>>
+        {
+            static constexpr size_t rank = std::max(sizeof...(A), sizeof...(B));
+            static constexpr std::array<size_t, rank> a_dims = pad_dims<rank, A...>();
+            static constexpr std::array<size_t, rank> b_dims = pad_dims<rank, B...>();
+
+            static constexpr bool valid = []() {
+                for (size_t i = 0; i < rank; i++)
+                    if (a_dims[i] != b_dims[i] && a_dims[i] != 1 && b_dims[i] != 1)
+                        return false;
+                return true;
+            }();
+
+            static constexpr std::array<size_t, rank> dims = []() {
+                std::array<size_t, rank> result{};
+                for (size_t i = 0; i < rank; i++)
+                    result[i] = a_dims[i] == 1 ? b_dims[i] : a_dims[i];
+                return result;
+            }();
+
+            static constexpr std::array<size_t, rank> a_strides = broadcast_strides(a_dims);
+            static constexpr std::array<size_t, rank> b_strides = broadcast_strides(b_dims);
+
+            static constexpr size_t size = get_size_range(dims, 0, rank);
+
+            // Offset into an operand with `strides` of every output element,
+            // for the unrolled small-shape path.
+            static constexpr std::array<size_t, size> offsets(const std::array<size_t, rank> &strides)
+            {
+                std::array<size_t, size> result{};
+                for (size_t i = 0; i < size; i++)
+                {
+                    size_t rest = i;
+                    for (size_t d = rank; d-- > 0;)
+                    {
+                        result[i] += rest % dims[d] * strides[d];
+                        rest /= dims[d];
+                    }
+                }
+                return result;
+            }
+
+            template <class T, class Seq = std::make_index_sequence<rank>>
+            struct tensor_of;
+
+            template <class T, size_t... I>
+            struct tensor_of<T, std::index_sequence<I...>>
+            {
+                typedef Tensor<T, dims[I]...> type;
+            };
+
+            template <class T>
+            using tensor = typename tensor_of<T>::type;
+        };
+
+        template <class A, class B>
+        struct broadcast_tensor;
+
+        template <class TA, class TB, size_t... A, size_t... B>
+        struct broadcast_tensor<Tensor<TA, A...>, Tensor<TB, B...>>
+            : broadcast_shape<std::index_sequence<A...>, std::index_sequence<B...>>
+        {
+        };
+
+        // Element type T over the broadcast shape of tensor types A and B.
+        template <class T, class A, class B>
+        using broadcast_t = typename broadcast_tensor<A, B>::template tensor<T>;
+
         template <class T, bool Cond, size_t... Dims>
         struct sub_cond
         {
@@ -97,7 +260,7 @@ namespace StaticNet
             }
             else
             {
-                return i[0];
+                return indices[i];
             }
         }
 
@@ -140,23 +303,6 @@ namespace StaticNet
             typedef Tensor<T, get_rank_dim<R, 0, D_...>()> type;
         };
 
-        template <size_t Rank, size_t i, size_t TDim, size_t... TDims>
-        std::array<size_t, Rank> get_transposed_index(const std::array<size_t, Rank> &idx)
-        {
-            if constexpr (sizeof...(TDims))
-            {
-                std::array<size_t, Rank> result = get_transposed_index<Rank, i + 1, TDims...>(idx);
-                result[i] = idx[TDim];
-                return result;
-            }
-            else
-            {
-                std::array<size_t, Rank> result;
-                result[i] = idx[TDim];
-                return result;
-            }
-        }
-
         template <size_t Rank, size_t i, size_t Dim, size_t... Dims>
         bool increment_indices(std::array<size_t, Rank> &indices)
         {
@@ -196,6 +342,24 @@ namespace StaticNet
         }
     }
 
+    // op(a, b) elementwise under NumPy broadcasting, in a's element type.
+    template <class AOrigin, class BOrigin, class T, class U, size_t... A, size_t... B, class Op>
+    TensorUtils::broadcast_t<T, Tensor<T, A...>, Tensor<U, B...>> broadcast(const TensorRef<AOrigin, Tensor<T, A...>> &a, const TensorRef<BOrigin, Tensor<U, B...>> &b, Op op);
+
+    // dst = op(dst, b), b broadcast to dst's shape.
+    template <class DstOrigin, class BOrigin, class T, class U, size_t... D, size_t... B, class Op>
+    void broadcast_to(TensorRef<DstOrigin, Tensor<T, D...>> dst, const TensorRef<BOrigin, Tensor<U, B...>> &b, Op op);
+
+    // Output axis i is source axis TDim[i].
+    template <size_t... TDim, class Origin, class T, size_t... D>
+    typename TensorUtils::transpose_helper<Tensor<T, D...>, Transpose<TDim...>>::type transpose(const TensorRef<Origin, Tensor<T, D...>> &src);
+
+    namespace TensorUtils
+    {
+        template <class Origin, class T, size_t... D, class F>
+        void with_contiguous(const TensorRef<Origin, Tensor<T, D...>> &src, F &&f);
+    }
+
     template <class T, size_t D, size_t... D_, size_t SliceD, size_t... SliceD_>
     class TensorRef<Tensor<T, D, D_...>, Tensor<T, SliceD, SliceD_...>>
     {
@@ -208,6 +372,8 @@ namespace StaticNet
         using This = TensorRef<Origin<T>, Tensor<T, SliceD, SliceD_...>>;
         using SubRef = typename TensorUtils::sub_cond_ref<T, Origin<T>, sizeof...(SliceD_), SliceD_...>::type;
 
+        static constexpr size_t Size = TensorUtils::get_size<SliceD, SliceD_...>();
+
         TensorRef(const Tensor<T, D, D_...> *const origin, size_t slice_start = 0)
             : slice_start(slice_start)
         {
@@ -246,22 +412,40 @@ namespace StaticNet
                 return origin->data[slice_start + i];
         }
 
+        // Copies elements; without it the implicit copy assignment would
+        // rebind a same-typed slice instead, e.g. for a[i] = b[i].
+        This &operator=(const This &other)
+        {
+            return this->operator=<T>(other);
+        }
+
+        // Elementwise operators run the flat loops in Kernels/Elementwise.h
+        // on dense views and recurse row by row only into strided ones, so
+        // each shape adds a call rather than its own copy of the loop.
         template <class U, size_t... OtherOriginDim>
         This &operator=(const TensorRef<Tensor<U, OtherOriginDim...>, Slice<U>> &other)
         {
-            for (size_t i = 0; i < SliceD; ++i)
-                (*this)[i] = other[i];
+            if constexpr (contiguous() && TensorRef<Tensor<U, OtherOriginDim...>, Slice<U>>::contiguous())
+                Kernels::copy(static_cast<const U *>(other.pointer()), pointer(), Size);
+            else
+                for (size_t i = 0; i < SliceD; ++i)
+                    (*this)[i] = other[i];
             return *this;
         }
 
         template <class U, size_t... OtherOriginDim>
         bool operator==(const TensorRef<Tensor<U, OtherOriginDim...>, Slice<U>> &other) const
         {
-            for (size_t i = 0; i < SliceD; i++)
-                if ((*this)[i] != other[i])
-                    return false;
+            if constexpr (sizeof...(SliceD_) == 0)
+                return Kernels::equal(static_cast<const T *>(pointer()), static_cast<const U *>(other.pointer()), Size);
+            else
+            {
+                for (size_t i = 0; i < SliceD; i++)
+                    if ((*this)[i] != other[i])
+                        return false;
 
-            return true;
+                return true;
+            }
         }
 
         template <class U, size_t... OtherOriginDim>
@@ -274,113 +458,152 @@ namespace StaticNet
             return true;
         }
 
-        template <class U, size_t... OtherOriginDim>
-        Slice<T> operator+(const TensorRef<Tensor<U, OtherOriginDim...>, Slice<U>> &other) const
+        // Arithmetic with another tensor broadcasts NumPy-style, e.g. a
+        // [batch, C, H, W] activation plus a [C, 1, 1] bias in one pass.
+        // Compound assignments require the result to keep this shape.
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        TensorUtils::broadcast_t<T, Slice<T>, Tensor<U, OtherDim...>> operator+(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other) const
         {
-            Slice<T> result;
-            for (size_t i = 0; i < SliceD; i++)
-                result[i] = (*this)[i] + other[i];
-            return result;
+            return broadcast(*this, other, std::plus<>());
         }
 
-        template <class U, size_t... OtherOriginDim>
-        This &operator+=(const TensorRef<Tensor<U, OtherOriginDim...>, Slice<U>> &other)
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        This &operator+=(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other)
         {
-            for (size_t i = 0; i < SliceD; i++)
-                (*this)[i] += other[i];
+            broadcast_to(*this, other, std::plus<>());
             return *this;
         }
 
-        template <class U, size_t... OtherOriginDim>
-        Slice<T> operator-(const TensorRef<Tensor<U, OtherOriginDim...>, Slice<U>> &other) const
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        TensorUtils::broadcast_t<T, Slice<T>, Tensor<U, OtherDim...>> operator-(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other) const
         {
-            Slice<T> result;
-            for (size_t i = 0; i < SliceD; i++)
-                result[i] = (*this)[i] - other[i];
-            return result;
+            return broadcast(*this, other, std::minus<>());
         }
 
-        template <class U, size_t... OtherOriginDim>
-        This &operator-=(const TensorRef<Tensor<U, OtherOriginDim...>, Slice<U>> &other)
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        This &operator-=(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other)
         {
-            for (size_t i = 0; i < SliceD; i++)
-                (*this)[i] -= other[i];
+            broadcast_to(*this, other, std::minus<>());
+            return *this;
+        }
+
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        TensorUtils::broadcast_t<T, Slice<T>, Tensor<U, OtherDim...>> operator*(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other) const
+        {
+            return broadcast(*this, other, std::multiplies<>());
+        }
+
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        This &operator*=(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other)
+        {
+            broadcast_to(*this, other, std::multiplies<>());
+            return *this;
+        }
+
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        TensorUtils::broadcast_t<T, Slice<T>, Tensor<U, OtherDim...>> operator/(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other) const
+        {
+            return broadcast(*this, other, std::divides<>());
+        }
+
+        template <class U, size_t... OtherOriginDim, size_t... OtherDim>
+        This &operator/=(const TensorRef<Tensor<U, OtherOriginDim...>, Tensor<U, OtherDim...>> &other)
+        {
+            broadcast_to(*this, other, std::divides<>());
             return *this;
         }
 
         template <class U>
+            requires std::is_arithmetic_v<U>
         Slice<T> operator*(U scalar) const
         {
             Slice<T> result;
-            for (size_t i = 0; i < SliceD; i++)
-                result[i] = (*this)[i] * scalar;
+            TensorUtils::with_contiguous(*this, [&](const T *in) {
+                Kernels::scale(in, result.data, Size, scalar);
+            });
             return result;
         }
 
         template <class U>
+            requires std::is_arithmetic_v<U>
         This &operator*=(U scalar)
         {
-            for (size_t i = 0; i < SliceD; i++)
-                (*this)[i] *= scalar;
+            if constexpr (contiguous())
+                Kernels::scale(static_cast<const T *>(pointer()), pointer(), Size, scalar);
+            else
+                for (size_t i = 0; i < SliceD; i++)
+                    (*this)[i] *= scalar;
             return *this;
         }
 
         template <class U>
+            requires std::is_arithmetic_v<U>
         Slice<T> operator/(U scalar) const
         {
             Slice<T> result;
-            for (size_t i = 0; i < SliceD; i++)
-                result[i] = (*this)[i] / scalar;
+            TensorUtils::with_contiguous(*this, [&](const T *in) {
+                Kernels::divide(in, result.data, Size, scalar);
+            });
             return result;
         }
 
         template <class U>
+            requires std::is_arithmetic_v<U>
         This &operator/=(U scalar)
         {
-            for (size_t i = 0; i < SliceD; i++)
-                (*this)[i] /= scalar;
+            if constexpr (contiguous())
+                Kernels::divide(static_cast<const T *>(pointer()), pointer(), Size, scalar);
+            else
+                for (size_t i = 0; i < SliceD; i++)
+                    (*this)[i] /= scalar;
             return *this;
         }
 
         Slice<T> operator-() const
         {
             Slice<T> result;
-            for (size_t i = 0; i < SliceD; i++)
-                result[i] = -(*this)[i];
+            TensorUtils::with_contiguous(*this, [&](const T *in) {
+                Kernels::negate(in, result.data, Size);
+            });
             return result;
         }
 
-        typename TensorUtils::sub_cond<T, sizeof...(SliceD_), SliceD_...>::type reduce() const
+        // True when the slice's trailing dims match the origin's, i.e. the
+        // elements form one dense block starting at pointer(). operator[]
+        // steps by the origin's strides, so a view that merely covers the
+        // whole origin, such as reshape_ref<4, 6>() of a [2, 3, 4] tensor,
+        // is not dense in its own index order.
+        static constexpr bool contiguous()
         {
-            if constexpr (sizeof...(SliceD_))
-            {
-                Tensor<T, SliceD_...> result;
-                for (size_t i = 0; i < SliceD; i++)
-                    result += (*this)[i];
+            constexpr std::array<size_t, sizeof...(D_) + 1> origin_dims = {D, D_...};
+            constexpr std::array<size_t, sizeof...(SliceD_) + 1> slice_dims = {SliceD, SliceD_...};
 
-                return result;
-            }
-            else
-            {
-                T result = T();
-                for (size_t i = 0; i < SliceD; i++)
-                    result += (*this)[i];
+            if (slice_dims.size() > origin_dims.size())
+                return false;
+            for (size_t i = 1; i < slice_dims.size(); i++)
+                if (slice_dims[slice_dims.size() - i] != origin_dims[origin_dims.size() - i])
+                    return false;
+            return true;
+        }
 
-                return result;
-            }
+        T *pointer() const
+        {
+            return origin->data + slice_start;
+        }
+
+        typename TensorUtils::sub_cond<T, sizeof...(SliceD_), SliceD_...>::type reduce() const
+        {
+            return reduce_sum<0>(*this);
         }
 
         template <size_t... P>
         Tensor<T, P...> reshape() const
         {
+            static_assert(TensorUtils::get_size<P...>() == Size, "Tensor size error");
             Tensor<T, P...> result;
-            std::array<size_t, sizeof...(SliceD_) + 1> indices = {0};
-            for (size_t i = 0; i < TensorUtils::get_size<P...>(); i++)
-            {
-                result.data[i] = get(indices);
-                TensorUtils::increment_indices<sizeof...(SliceD_) + 1, 0, SliceD, SliceD_...>(indices);
-            }
-
+            TensorUtils::with_contiguous(*this, [&](const T *in) {
+                Kernels::copy(in, result.data, Size);
+            });
             return result;
         }
 
@@ -414,30 +637,6 @@ namespace StaticNet
             return result;
         }
 
-        template <class TDst, class Th, size_t i, size_t... TDim>
-        static void assign_transpose(
-            TDst &dst,
-            const Th &src,
-            std::array<size_t, sizeof...(TDim)> &indices)
-        {
-            if constexpr (i == sizeof...(TDim) - 1)
-            {
-                for (size_t j = 0; j < SliceD; j++)
-                {
-                    indices[i] = j;
-                    dst.get(TensorUtils::get_transposed_index<sizeof...(TDim), 0, TDim...>(indices)) = src.get(indices);
-                }
-            }
-            else
-            {
-                for (size_t j = 0; j < SliceD; j++)
-                {
-                    indices[i] = j;
-                    TensorRef<Tensor<T, D, D_...>, Tensor<T, SliceD_...>>::template assign_transpose<TDst, Th, i + 1, TDim...>(dst, src, indices);
-                }
-            }
-        }
-
         template <size_t N, size_t i = 0>
         T &get(const std::array<size_t, N> &indices)
         {
@@ -459,38 +658,17 @@ namespace StaticNet
         template <size_t... TDim>
         typename TensorUtils::transpose_helper<Tensor<T, SliceD, SliceD_...>, Transpose<TDim...>>::type transpose() const
         {
-            static_assert(TensorUtils::get_rank<TDim...>() == TensorUtils::get_rank<SliceD, SliceD_...>(), "Tensor transpose error");
-
-            std::array<size_t, sizeof...(TDim)> indices;
-            typename TensorUtils::transpose_helper<Tensor<T, SliceD, SliceD_...>, Transpose<TDim...>>::type result;
-            assign_transpose<
-                typename TensorUtils::transpose_helper<Tensor<T, SliceD, SliceD_...>, Transpose<TDim...>>::type,
-                This,
-                0,
-                TDim...>(result, *this, indices);
-
-            return result;
+            return StaticNet::transpose<TDim...>(*this);
         }
 
         template <class Other>
         Tensor<Other, SliceD, SliceD_...> map(const std::function<Other(T)> &f) const
         {
-            if constexpr (sizeof...(SliceD_))
-            {
-                Tensor<Other, SliceD, SliceD_...> result;
-                for (size_t i = 0; i < SliceD; i++)
-                    result[i] = (*this)[i].map(f);
-
-                return result;
-            }
-            else
-            {
-                Tensor<Other, SliceD> result;
-                for (size_t i = 0; i < SliceD; i++)
-                    result[i] = f((*this)[i]);
-
-                return result;
-            }
+            Tensor<Other, SliceD, SliceD_...> result;
+            TensorUtils::with_contiguous(*this, [&](const T *in) {
+                Kernels::map(in, result.data, Size, f);
+            });
+            return result;
         }
 
         template <class Other, size_t FD>
@@ -529,8 +707,8 @@ namespace StaticNet
         Tensor(const T &value = T())
             : TensorRef<This, This>(this)
         {
-            this->data = new T[TensorUtils::get_size<D, D_...>()];
-            std::fill(this->data, this->data + TensorUtils::get_size<D, D_...>(), value);
+            this->data = TensorUtils::allocate<T>(TensorUtils::get_size<D, D_...>());
+            TensorUtils::fill(this->data, TensorUtils::get_size<D, D_...>(), value);
         }
 
         Tensor(This &other)
@@ -559,7 +737,7 @@ namespace StaticNet
         Tensor(const TensorRef<OtherOrigin, This> &other)
             : TensorRef<This, This>(this)
         {
-            this->data = new T[TensorUtils::get_size<D, D_...>()];
+            this->data = TensorUtils::allocate<T>(TensorUtils::get_size<D, D_...>());
             for (size_t i = 0; i < D; i++)
                 (*this)[i] = other[i];
         }
@@ -567,7 +745,7 @@ namespace StaticNet
         Tensor(const std::initializer_list<Sub> &list)
             : TensorRef<This, This>(this)
         {
-            this->data = new T[TensorUtils::get_size<D, D_...>()];
+            this->data = TensorUtils::allocate<T>(TensorUtils::get_size<D, D_...>());
             size_t idx = 0;
             for (const auto &sub : list)
                 (*this)[idx++] = sub;
@@ -579,22 +757,13 @@ namespace StaticNet
                 delete[] this->data;
         }
 
+        // rand<T>()-distributed values from the next stream of the global
+        // seed, reproducible for any thread count.
         static This random()
         {
-            if constexpr (sizeof...(D_))
-            {
-                This result;
-                for (size_t i = 0; i < D; i++)
-                    result[i] = Sub::random();
-                return result;
-            }
-            else
-            {
-                This result;
-                for (size_t i = 0; i < D; i++)
-                    result[i] = Random::rand<T>();
-                return result;
-            }
+            This result;
+            Random::fill(result.data, TensorUtils::get_size<D, D_...>());
+            return result;
         }
 
         template <size_t... P>
@@ -637,94 +806,446 @@ namespace StaticNet
     };
 
     template <class AOrigin, class BOrigin, class T, size_t D1, size_t D2, size_t D3>
-    Tensor<T, D1, D3> dot(const TensorRef<AOrigin, Tensor<T, D1, D2>> &a, const TensorRef<BOrigin, Tensor<T, D2, D3>> &b)
+    Tensor<T, D1, D3> dot(const TensorRef<AOrigin, Tensor<T, D1, D2>> &a, const TensorRef<BOrigin, Tensor<T, D2, D3>> &b);
+
+    // a^T b for a [D2, D1], without materializing the transpose.
+    template <class AOrigin, class BOrigin, class T, size_t D1, size_t D2, size_t D3>
+    Tensor<T, D1, D3> dot_tn(const TensorRef<AOrigin, Tensor<T, D2, D1>> &a, const TensorRef<BOrigin, Tensor<T, D2, D3>> &b);
+
+    // a b^T for b [D3, D2], without materializing the transpose.
+    template <class AOrigin, class BOrigin, class T, size_t D1, size_t D2, size_t D3>
+    Tensor<T, D1, D3> dot_nt(const TensorRef<AOrigin, Tensor<T, D1, D2>> &a, const TensorRef<BOrigin, Tensor<T, D3, D2>> &b);
+
+    template <class AOrigin, class BOrigin, class T, size_t... D>
+    Tensor<T, D...> hadamard(const TensorRef<AOrigin, Tensor<T, D...>> &a, const TensorRef<BOrigin, Tensor<T, D...>> &b);
+
+    namespace TensorUtils
     {
-        Tensor<T, D1, D3> result;
-        auto b_transposed = b.template transpose<1, 0>();
+        // Calls f with a dense pointer to src, copying only non-contiguous views.
+        template <class Origin, class T, size_t... D, class F>
+        void with_contiguous(const TensorRef<Origin, Tensor<T, D...>> &src, F &&f)
+        {
+            if constexpr (TensorRef<Origin, Tensor<T, D...>>::contiguous())
+            {
+                f(static_cast<const T *>(src.pointer()));
+            }
+            else
+            {
+                Tensor<T, D...> copy(src);
+                f(static_cast<const T *>(copy.data));
+            }
+        }
 
-#pragma omp parallel for default(shared)
-        for (int i = 0; i < D1; i++)
-            for (int j = 0; j < D3; j++)
+        // Calls f with a dense pointer whose contents end up in dst.
+        template <class Origin, class T, size_t... D, class F>
+        void with_contiguous_output(TensorRef<Origin, Tensor<T, D...>> dst, F &&f)
+        {
+            if constexpr (TensorRef<Origin, Tensor<T, D...>>::contiguous())
             {
-                Tensor<T, D2> a_sub = a[i];
-                Tensor<T, D2> b_sub = b_transposed[j];
-                result[i][j] = std::inner_product(a_sub.data, a_sub.data + D2, b_sub.data, T());
+                f(dst.pointer());
             }
+            else
+            {
+                Tensor<T, D...> result;
+                f(result.data);
+                dst = result;
+            }
+        }
+
+        template <size_t Axis, class Origin, class T, size_t... D, class U, class Kernel>
+        void reduce_axis(const TensorRef<Origin, Tensor<T, D...>> &src, U *dst, Kernel kernel)
+        {
+            constexpr std::array<size_t, sizeof...(D)> dims = {D...};
+            STATICNET_PROFILE_KERNEL("reduce", get_size<D...>(), sizeof(T) * get_size<D...>());
+
+            with_contiguous(src, [&](const T *in) {
+                kernel(in, dst, get_size_range(dims, 0, Axis), dims[Axis], get_size_range(dims, Axis + 1, dims.size()));
+            });
+        }
+
+        template <class T, size_t Axis, size_t... D>
+        using reduced = typename remove_axis<T, Axis, D...>::type;
+    }
 
+    template <class AOrigin, class BOrigin, class T, size_t... D>
+    Tensor<T, D...> hadamard(const TensorRef<AOrigin, Tensor<T, D...>> &a, const TensorRef<BOrigin, Tensor<T, D...>> &b)
+    {
+        constexpr size_t size = TensorUtils::get_size<D...>();
+        STATICNET_PROFILE_KERNEL("hadamard", size, 3 * sizeof(T) * size);
+        Tensor<T, D...> result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const T *pb) {
+                if constexpr (size <= Kernels::SmallThreshold)
+                    Kernels::Small<size>::zip(pa, pb, result.data, std::multiplies<>());
+                else
+                    Kernels::multiply(pa, pb, result.data, size);
+            });
+        });
         return result;
     }
 
-    template <class AOrigin, class BOrigin, class T, size_t D, size_t... D_>
-    Tensor<T, D, D_...> hadamard(const TensorRef<AOrigin, Tensor<T, D, D_...>> &a, const TensorRef<BOrigin, Tensor<T, D, D_...>> &b)
+    template <class AOrigin, class BOrigin, class T, size_t D1, size_t D2, size_t D3>
+    Tensor<T, D1, D3> dot(const TensorRef<AOrigin, Tensor<T, D1, D2>> &a, const TensorRef<BOrigin, Tensor<T, D2, D3>> &b)
     {
-        Tensor<T, D, D_...> result;
+        STATICNET_PROFILE_KERNEL("dot", 2 * D1 * D2 * D3, sizeof(T) * (D1 * D2 + D2 * D3 + D1 * D3));
+        Tensor<T, D1, D3> result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const T *pb) {
+                if constexpr (D1 * D2 * D3 <= Kernels::SmallProduct)
+                {
+                    for (size_t i = 0; i < D1; i++)
+                        for (size_t j = 0; j < D3; j++)
+                            result.data[i * D3 + j] = Kernels::Small<D2>::dot(pa + i * D2, pb + j, D3);
+                }
+                else
+                    Kernels::gemm(pa, pb, result.data, D1, D2, D3);
+            });
+        });
+        return result;
+    }
 
-        for (size_t i = 0; i < D; i++)
-            result[i] = hadamard(a[i], b[i]);
+    template <class AOrigin, class BOrigin, class T, size_t D1, size_t D2, size_t D3>
+    Tensor<T, D1, D3> dot_tn(const TensorRef<AOrigin, Tensor<T, D2, D1>> &a, const TensorRef<BOrigin, Tensor<T, D2, D3>> &b)
+    {
+        STATICNET_PROFILE_KERNEL("dot", 2 * D1 * D2 * D3, sizeof(T) * (D1 * D2 + D2 * D3 + D1 * D3));
+        Tensor<T, D1, D3> result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const T *pb) {
+                Kernels::gemm_tn(pa, pb, result.data, D1, D2, D3);
+            });
+        });
+        return result;
+    }
 
+    template <class AOrigin, class BOrigin, class T, size_t D1, size_t D2, size_t D3>
+    Tensor<T, D1, D3> dot_nt(const TensorRef<AOrigin, Tensor<T, D1, D2>> &a, const TensorRef<BOrigin, Tensor<T, D3, D2>> &b)
+    {
+        STATICNET_PROFILE_KERNEL("dot", 2 * D1 * D2 * D3, sizeof(T) * (D1 * D2 + D2 * D3 + D1 * D3));
+        Tensor<T, D1, D3> result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const T *pb) {
+                Kernels::gemm_nt(pa, pb, result.data, D1, D2, D3);
+            });
+        });
         return result;
     }
 
-    template <class AOrigin, class BOrigin, class T, size_t D1, size_t D2>
-    Tensor<T, D1, D2> hadamard(const TensorRef<AOrigin, Tensor<T, D1, D2>> &a, const TensorRef<BOrigin, Tensor<T, D1, D2>> &b)
+    // ------------------------------------------------------------------------
+    // Batched matrix products over a leading batch axis, one kernel call for
+    // the whole batch (e.g. every group of a grouped convolution). A rank-2
+    // right-hand side is shared by every batch entry.
+    // ------------------------------------------------------------------------
+
+    template <class AOrigin, class BOrigin, class T, size_t B, size_t M, size_t K, size_t N>
+    Tensor<T, B, M, N> batched_dot(const TensorRef<AOrigin, Tensor<T, B, M, K>> &a, const TensorRef<BOrigin, Tensor<T, B, K, N>> &b)
     {
-        Tensor<T, D1, D2> result;
+        STATICNET_PROFILE_KERNEL("batched_dot", 2 * B * M * K * N, sizeof(T) * B * (M * K + K * N + M * N));
+        Tensor<T, B, M, N> result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const T *pb) {
+                Kernels::batched_gemm(pa, M * K, pb, K * N, result.data, M * N, B, M, K, N);
+            });
+        });
+        return result;
+    }
 
-#pragma omp parallel for default(shared)
-        for (int i = 0; i < D1; i++)
-            for (int j = 0; j < D2; j++)
-                result[i][j] = a[i][j] * b[i][j];
+    template <class AOrigin, class BOrigin, class T, size_t B, size_t M, size_t K, size_t N>
+    Tensor<T, B, M, N> batched_dot(const TensorRef<AOrigin, Tensor<T, B, M, K>> &a, const TensorRef<BOrigin, Tensor<T, K, N>> &b)
+    {
+        STATICNET_PROFILE_KERNEL("batched_dot", 2 * B * M * K * N, sizeof(T) * (B * M * K + K * N + B * M * N));
+        Tensor<T, B, M, N> result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const T *pb) {
+                Kernels::batched_gemm(pa, M * K, pb, 0, result.data, M * N, B, M, K, N);
+            });
+        });
+        return result;
+    }
 
+    // a[i] b[i]^T for b [B, N, K].
+    template <class AOrigin, class BOrigin, class T, size_t B, size_t M, size_t K, size_t N>
+    Tensor<T, B, M, N> batched_dot_nt(const TensorRef<AOrigin, Tensor<T, B, M, K>> &a, const TensorRef<BOrigin, Tensor<T, B, N, K>> &b)
+    {
+        STATICNET_PROFILE_KERNEL("batched_dot", 2 * B * M * K * N, sizeof(T) * B * (M * K + K * N + M * N));
+        Tensor<T, B, M, N> result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const T *pb) {
+                Kernels::batched_gemm_nt(pa, M * K, pb, N * K, result.data, M * N, B, M, K, N);
+            });
+        });
         return result;
     }
 
-    template <class AOrigin, class BOrigin, class T, size_t D>
-    Tensor<T, D> hadamard(const TensorRef<AOrigin, Tensor<T, D>> &a, const TensorRef<BOrigin, Tensor<T, D>> &b)
+    template <class AOrigin, class BOrigin, class T, class U, size_t... A, size_t... B, class Op>
+    TensorUtils::broadcast_t<T, Tensor<T, A...>, Tensor<U, B...>> broadcast(const TensorRef<AOrigin, Tensor<T, A...>> &a, const TensorRef<BOrigin, Tensor<U, B...>> &b, Op op)
     {
-        Tensor<T, D> result;
+        using Shape = TensorUtils::broadcast_tensor<Tensor<T, A...>, Tensor<U, B...>>;
+        static_assert(Shape::valid, "Tensor shapes are not broadcastable");
+        static_assert(Shape::rank <= Kernels::BroadcastMaxRank, "Tensor rank too large to broadcast");
 
-#pragma omp parallel for default(shared)
-        for (int i = 0; i < D; i++)
-            result[i] = a[i] * b[i];
+        using Result = TensorUtils::broadcast_t<T, Tensor<T, A...>, Tensor<U, B...>>;
+        STATICNET_PROFILE_KERNEL("broadcast", Shape::size, sizeof(T) * (TensorUtils::get_size<A...>() + Shape::size) + sizeof(U) * TensorUtils::get_size<B...>());
 
+        Result result;
+        TensorUtils::with_contiguous(a, [&](const T *pa) {
+            TensorUtils::with_contiguous(b, [&](const U *pb) {
+                if constexpr (Shape::size <= Kernels::SmallThreshold)
+                {
+                    static constexpr auto ia = Shape::offsets(Shape::a_strides), ib = Shape::offsets(Shape::b_strides);
+                    Kernels::Small<Shape::size>::zip(pa, ia.data(), pb, ib.data(), result.data, op);
+                }
+                else
+                    Kernels::broadcast(pa, Shape::a_strides.data(), pb, Shape::b_strides.data(), result.data,
+                                       Shape::dims.data(), Shape::rank, op);
+            });
+        });
         return result;
     }
 
-    template <size_t K, class IOrigin, class T, size_t Batch, size_t C, size_t IDim>
-    Tensor<T, Batch *(IDim - K + 1) * (IDim - K + 1), C * K * K> im2col(const TensorRef<IOrigin, Tensor<T, Batch, C, IDim, IDim>> &input)
+    template <class DstOrigin, class BOrigin, class T, class U, size_t... D, size_t... B, class Op>
+    void broadcast_to(TensorRef<DstOrigin, Tensor<T, D...>> dst, const TensorRef<BOrigin, Tensor<U, B...>> &b, Op op)
     {
-        constexpr size_t ODim = (IDim - K + 1);
-        Tensor<T, Batch, C, K, K, ODim, ODim> col;
-        for (int i = 0; i < K; i++)
-            for (int j = 0; j < K; j++)
-            {
-                col.template slice<Batch, C, 1, 1, ODim, ODim>({0, 0, (size_t)i, (size_t)j, 0, 0}) =
-                    input.template slice<Batch, C, ODim, ODim>({0, 0, (size_t)i, (size_t)j})
-                        .template reshape<Batch, C, 1, 1, ODim, ODim>();
-            }
+        using Shape = TensorUtils::broadcast_tensor<Tensor<T, D...>, Tensor<U, B...>>;
+        static_assert(Shape::valid, "Tensor shapes are not broadcastable");
+        static_assert(std::is_same_v<typename Shape::template tensor<T>, Tensor<T, D...>>, "Broadcast result must keep the destination shape");
+        static_assert(Shape::rank <= Kernels::BroadcastMaxRank, "Tensor rank too large to broadcast");
+
+        STATICNET_PROFILE_KERNEL("broadcast", Shape::size, 2 * sizeof(T) * Shape::size + sizeof(U) * TensorUtils::get_size<B...>());
+
+        auto run = [&](T *out) {
+            TensorUtils::with_contiguous(b, [&](const U *pb) {
+                if constexpr (Shape::size <= Kernels::SmallThreshold)
+                {
+                    static constexpr auto ia = Shape::offsets(Shape::a_strides), ib = Shape::offsets(Shape::b_strides);
+                    Kernels::Small<Shape::size>::zip(static_cast<const T *>(out), ia.data(), pb, ib.data(), out, op);
+                }
+                else
+                    Kernels::broadcast(static_cast<const T *>(out), Shape::a_strides.data(), pb, Shape::b_strides.data(), out,
+                                       Shape::dims.data(), Shape::rank, op);
+            });
+        };
 
-        return col.template transpose<0, 4, 5, 1, 2, 3>()
-            .template reshape<Batch * ODim * ODim, C * K * K>();
+        if constexpr (TensorRef<DstOrigin, Tensor<T, D...>>::contiguous())
+        {
+            run(dst.pointer());
+        }
+        else
+        {
+            const auto &view = dst;
+            Tensor<T, D...> copy(view);
+            run(copy.data);
+            dst = copy;
+        }
     }
 
-    template <class T, size_t K, size_t Batch, size_t C, size_t IDim>
-    Tensor<T, Batch, C, IDim, IDim> col2im(const Tensor<T, Batch *(IDim - K + 1) * (IDim - K + 1), C * K * K> &col)
+    template <size_t... TDim, class Origin, class T, size_t... D>
+    typename TensorUtils::transpose_helper<Tensor<T, D...>, Transpose<TDim...>>::type transpose(const TensorRef<Origin, Tensor<T, D...>> &src)
     {
-        constexpr size_t ODim = (IDim - K + 1);
-        Tensor<T, Batch, C, K, K, ODim, ODim> col_reshaped = (col.template reshape<Batch, ODim, ODim, C, K, K>()).transpose<0, 3, 4, 5, 1, 2>();
+        static_assert(TensorUtils::get_rank<TDim...>() == TensorUtils::get_rank<D...>(), "Tensor transpose error");
+        STATICNET_PROFILE_KERNEL("transpose", 0, 2 * sizeof(T) * TensorUtils::get_size<D...>());
 
-        Tensor<T, Batch, C, IDim, IDim> result;
-        for (int i = 0; i < K; i++)
-            for (int j = 0; j < K; j++)
-            {
-                result.template slice<Batch, C, ODim, ODim>({0, 0, (size_t)i, (size_t)j}) +=
-                    col_reshaped.template slice<Batch, C, 1, 1, ODim, ODim>({0, 0, (size_t)i, (size_t)j, 0, 0})
-                        .template reshape<Batch, C, ODim, ODim>();
-            }
+        static constexpr size_t dims[] = {D...}, perm[] = {TDim...};
+        static constexpr Kernels::PermutePlan plan = Kernels::make_permute_plan(dims, perm, sizeof...(D));
+
+        typename TensorUtils::transpose_helper<Tensor<T, D...>, Transpose<TDim...>>::type result;
+        TensorUtils::with_contiguous(src, [&](const T *in) {
+            Kernels::permute(in, result.data, plan);
+        });
+        return result;
+    }
+
+    // ------------------------------------------------------------------------
+    // Reductions along a static axis. The two-argument forms write into a
+    // preallocated destination; a rank-1 source reduces to a scalar.
+    // ------------------------------------------------------------------------
+
+    template <size_t Axis, class Origin, class DstOrigin, class T, size_t... D, size_t... R>
+    void reduce_sum(const TensorRef<Origin, Tensor<T, D...>> &src, TensorRef<DstOrigin, Tensor<T, R...>> dst)
+    {
+        static_assert(std::is_same_v<Tensor<T, R...>, TensorUtils::reduced<T, Axis, D...>>, "Reduction destination shape error");
+        TensorUtils::with_contiguous_output(dst, [&](T *out) {
+            TensorUtils::reduce_axis<Axis>(src, out, Kernels::reduce_sum<T>);
+        });
+    }
+
+    template <size_t Axis, class Origin, class T, size_t D>
+    void reduce_sum(const TensorRef<Origin, Tensor<T, D>> &src, T &dst)
+    {
+        TensorUtils::reduce_axis<Axis>(src, &dst, Kernels::reduce_sum<T>);
+    }
 
+    template <size_t Axis, class Origin, class T, size_t... D>
+    TensorUtils::reduced<T, Axis, D...> reduce_sum(const TensorRef<Origin, Tensor<T, D...>> &src)
+    {
+        TensorUtils::reduced<T, Axis, D...> result{};
+        reduce_sum<Axis>(src, result);
         return result;
     }
 
+    template <size_t Axis, class Origin, class DstOrigin, class T, size_t... D, size_t... R>
+    void reduce_mean(const TensorRef<Origin, Tensor<T, D...>> &src, TensorRef<DstOrigin, Tensor<T, R...>> dst)
+    {
+        constexpr size_t N = TensorUtils::get_rank_dim<Axis, 0, D...>();
+        static_assert(std::is_same_v<Tensor<T, R...>, TensorUtils::reduced<T, Axis, D...>>, "Reduction destination shape error");
+        TensorUtils::with_contiguous_output(dst, [&](T *out) {
+            TensorUtils::reduce_axis<Axis>(src, out, Kernels::reduce_sum<T>);
+#pragma omp simd
+            for (size_t i = 0; i < TensorUtils::get_size<R...>(); i++)
+                out[i] /= (T)N;
+        });
+    }
+
+    template <size_t Axis, class Origin, class T, size_t D>
+    void reduce_mean(const TensorRef<Origin, Tensor<T, D>> &src, T &dst)
+    {
+        TensorUtils::reduce_axis<Axis>(src, &dst, Kernels::reduce_sum<T>);
+        dst /= (T)D;
+    }
+
+    template <size_t Axis, class Origin, class T, size_t... D>
+    TensorUtils::reduced<T, Axis, D...> reduce_mean(const TensorRef<Origin, Tensor<T, D...>> &src)
+    {
+        TensorUtils::reduced<T, Axis, D...> result{};
+        reduce_mean<Axis>(src, result);
+        return result;
+    }
+
+    template <size_t Axis, class Origin, class DstOrigin, class T, size_t... D, size_t... R>
+    void reduce_max(const TensorRef<Origin, Tensor<T, D...>> &src, TensorRef<DstOrigin, Tensor<T, R...>> dst)
+    {
+        static_assert(std::is_same_v<Tensor<T, R...>, TensorUtils::reduced<T, Axis, D...>>, "Reduction destination shape error");
+        TensorUtils::with_contiguous_output(dst, [&](T *out) {
+            TensorUtils::reduce_axis<Axis>(src, out, Kernels::reduce_max<T>);
+        });
+    }
+
+    template <size_t Axis, class Origin, class T, size_t D>
+    void reduce_max(const TensorRef<Origin, Tensor<T, D>> &src, T &dst)
+    {
+        TensorUtils::reduce_axis<Axis>(src, &dst, Kernels::reduce_max<T>);
+    }
+
+    template <size_t Axis, class Origin, class T, size_t... D>
+    TensorUtils::reduced<T, Axis, D...> reduce_max(const TensorRef<Origin, Tensor<T, D...>> &src)
+    {
+        TensorUtils::reduced<T, Axis, D...> result{};
+        reduce_max<Axis>(src, result);
+        return result;
+    }
+
+    template <size_t Axis, class Origin, class DstOrigin, class T, size_t... D, size_t... R>
+    void reduce_argmax(const TensorRef<Origin, Tensor<T, D...>> &src, TensorRef<DstOrigin, Tensor<size_t, R...>> dst)
+    {
+        static_assert(std::is_same_v<Tensor<size_t, R...>, TensorUtils::reduced<size_t, Axis, D...>>, "Reduction destination shape error");
+        TensorUtils::with_contiguous_output(dst, [&](size_t *out) {
+            TensorUtils::reduce_axis<Axis>(src, out, Kernels::reduce_argmax<T>);
+        });
+    }
+
+    template <size_t Axis, class Origin, class T, size_t D>
+    void reduce_argmax(const TensorRef<Origin, Tensor<T, D>> &src, size_t &dst)
+    {
+        TensorUtils::reduce_axis<Axis>(src, &dst, Kernels::reduce_argmax<T>);
+    }
+
+    template <size_t Axis, class Origin, class T, size_t... D>
+    TensorUtils::reduced<size_t, Axis, D...> reduce_argmax(const TensorRef<Origin, Tensor<T, D...>> &src)
+    {
+        TensorUtils::reduced<size_t, Axis, D...> result{};
+        reduce_argmax<Axis>(src, result);
+        return result;
+    }
+
+    // Sums over every axis except Axis, e.g. per-channel bias gradients.
+    template <size_t Axis, class Origin, class DstOrigin, class T, size_t... D, size_t R>
+    void reduce_sum_except(const TensorRef<Origin, Tensor<T, D...>> &src, TensorRef<DstOrigin, Tensor<T, R>> dst)
+    {
+        constexpr std::array<size_t, sizeof...(D)> dims = {D...};
+        static_assert(R == dims[Axis], "Reduction destination shape error");
+        STATICNET_PROFILE_KERNEL("reduce", TensorUtils::get_size<D...>(), sizeof(T) * TensorUtils::get_size<D...>());
+
+        TensorUtils::with_contiguous_output(dst, [&](T *out) {
+            TensorUtils::with_contiguous(src, [&](const T *in) {
+                Kernels::reduce_sum_keep(in, out,
+                                         TensorUtils::get_size_range(dims, 0, Axis),
+                                         dims[Axis],
+                                         TensorUtils::get_size_range(dims, Axis + 1, dims.size()));
+            });
+        });
+    }
+
+    template <size_t Axis, class Origin, class T, size_t... D>
+    Tensor<T, TensorUtils::get_rank_dim<Axis, 0, D...>()> reduce_sum_except(const TensorRef<Origin, Tensor<T, D...>> &src)
+    {
+        Tensor<T, TensorUtils::get_rank_dim<Axis, 0, D...>()> result;
+        reduce_sum_except<Axis>(src, result);
+        return result;
+    }
+
+    // Compile-time description of a 2-D convolution window; H and W
+    // default to the same size, stride 1, no padding and no dilation.
+    template <size_t KH, size_t KW = KH, size_t SH = 1, size_t SW = SH,
+              size_t PH = 0, size_t PW = PH, size_t DH = 1, size_t DW = DH>
+    struct Window2D
+    {
+        static constexpr size_t kh = KH, kw = KW;
+        static constexpr size_t sh = SH, sw = SW;
+        static constexpr size_t ph = PH, pw = PW;
+        static constexpr size_t dh = DH, dw = DW;
+
+        static constexpr size_t output_h(size_t ih) { return Kernels::conv_output(ih, KH, SH, PH, DH); }
+        static constexpr size_t output_w(size_t iw) { return Kernels::conv_output(iw, KW, SW, PW, DW); }
+
+        static constexpr Kernels::Conv2DGeometry geometry(size_t channels, size_t ih, size_t iw)
+        {
+            return {channels, ih, iw, KH, KW, SH, SW, PH, PW, DH, DW};
+        }
+    };
+
+    template <class Window, class IOrigin, class T, size_t Batch, size_t C, size_t IH, size_t IW>
+    Tensor<T, Batch * Window::output_h(IH) * Window::output_w(IW), C * Window::kh * Window::kw>
+    im2col(const TensorRef<IOrigin, Tensor<T, Batch, C, IH, IW>> &input)
+    {
+        constexpr size_t Rows = Batch * Window::output_h(IH) * Window::output_w(IW);
+        constexpr size_t Cols = C * Window::kh * Window::kw;
+        STATICNET_PROFILE_KERNEL("im2col", 0, sizeof(T) * (Batch * C * IH * IW + Rows * Cols));
+
+        Tensor<T, Rows, Cols> col;
+        TensorUtils::with_contiguous(input, [&](const T *in) {
+            Kernels::im2col(in, col.data, Batch, Window::geometry(C, IH, IW));
+        });
+        return col;
+    }
+
+    template <class Window, size_t IH, size_t IW, class Origin, class T, size_t Rows, size_t Cols>
+    Tensor<T, Rows / (Window::output_h(IH) * Window::output_w(IW)), Cols / (Window::kh * Window::kw), IH, IW>
+    col2im(const TensorRef<Origin, Tensor<T, Rows, Cols>> &col)
+    {
+        constexpr size_t Batch = Rows / (Window::output_h(IH) * Window::output_w(IW));
+        constexpr size_t C = Cols / (Window::kh * Window::kw);
+        static_assert(Batch * Window::output_h(IH) * Window::output_w(IW) == Rows && C * Window::kh * Window::kw == Cols,
+                      "col2im shape error");
+        STATICNET_PROFILE_KERNEL("col2im", Rows * Cols, sizeof(T) * (Batch * C * IH * IW + Rows * Cols));
+
+        Tensor<T, Batch, C, IH, IW> result;
+        TensorUtils::with_contiguous(col, [&](const T *in) {
+            Kernels::col2im(in, result.data, Batch, Window::geometry(C, IH, IW));
+        });
+        return result;
+    }
+
+    template <size_t K, class IOrigin, class T, size_t Batch, size_t C, size_t IDim>
+    Tensor<T, Batch *(IDim - K + 1) * (IDim - K + 1), C * K * K> im2col(const TensorRef<IOrigin, Tensor<T, Batch, C, IDim, IDim>> &input)
+    {
+        return im2col<Window2D<K>>(input);
+    }
+
+    template <class T, size_t K, size_t Batch, size_t C, size_t IDim>
+    Tensor<T, Batch, C, IDim, IDim> col2im(const Tensor<T, Batch *(IDim - K + 1) * (IDim - K + 1), C * K * K> &col)
+    {
+        return col2im<Window2D<K>, IDim, IDim>(col);
+    }
+
     template <class Origin, class T, size_t D>
     Tensor<T, D, D> flip(const TensorRef<Origin, Tensor<T, D, D>> &input)
     {
@@ -763,7 +1284,7 @@ namespace StaticNet
     template <size_t P, class Origin, class T, size_t D>
     Tensor<T, D + 2 * P, D + 2 * P> pad2d(const TensorRef<Origin, Tensor<T, D, D>> &input, T pad_value = T())
     {
-        Tensor<T, D + 2 * P, D + 2 * P> result{pad_value};
+        Tensor<T, D + 2 * P, D + 2 * P> result(pad_value);
 
 #pragma omp parallel for default(shared)
         for (int i = 0; i < D; i++)
@@ -776,10 +1297,10 @@ namespace StaticNet
     template <size_t P, class Origin, class T, size_t C, size_t D>
     Tensor<T, C, D + 2 * P, D + 2 * P> pad2d(const TensorRef<Origin, Tensor<T, C, D, D>> &input, T pad_value = T())
     {
-        Tensor<T, C, D + 2 * P, D + 2 * P> result{pad_value};
+        Tensor<T, C, D + 2 * P, D + 2 * P> result(pad_value);
 
         for (size_t i = 0; i < C; i++)
-            result[i] = pad(input[i], pad_value);
+            result[i] = pad2d<P>(input[i], pad_value);
 
         return result;
     }
@@ -788,6 +1309,7 @@ namespace StaticNet
     Tensor<T, ODim, ODim> pool(const Tensor<T, IDim, IDim> &input, std::function<T(const Tensor<T, IDim / ODim, IDim / ODim> &)> pool_func)
     {
         constexpr size_t KernelSize = IDim / ODim;
+        STATICNET_PROFILE_KERNEL("pool", IDim * IDim, sizeof(T) * (IDim * IDim + ODim * ODim));
         Tensor<T, ODim, ODim> result;
 
         for (int i = 0; i < ODim; i++)
@@ -809,6 +1331,7 @@ namespace StaticNet
     {
         constexpr size_t ODim = IDim * KDim;
         constexpr size_t KernelSize = KDim;
+        STATICNET_PROFILE_KERNEL("unpool", ODim * ODim, sizeof(T) * (IDim * IDim + ODim * ODim));
         Tensor<T, IDim * KDim, IDim * KDim> result;
 
         for (int i = 0; i < IDim; i++)
@@ -823,20 +1346,37 @@ namespace StaticNet
         return result;
     }
 
+    // First index of the largest element.
     template <class Origin, class T, size_t D>
     size_t argmax(const TensorRef<Origin, Tensor<T, D>> &t)
     {
-        T max = std::numeric_limits<T>::lowest();
-        size_t max_idx = -1;
+        size_t result = 0;
+        TensorUtils::with_contiguous(t, [&](const T *in) {
+            result = Kernels::Small<D>::argmax(in);
+        });
+        return result;
+    }
 
-        for (size_t i = 0; i < D; i++)
-            if (t[i] > max)
+    // Softmax along the last axis.
+    template <class Origin, class T, size_t... D>
+    Tensor<T, D...> softmax(const TensorRef<Origin, Tensor<T, D...>> &src)
+    {
+        constexpr std::array<size_t, sizeof...(D)> dims = {D...};
+        constexpr size_t N = dims.back(), Rows = TensorUtils::get_size<D...>() / N;
+        STATICNET_PROFILE_KERNEL("softmax", 4 * Rows * N, 2 * sizeof(T) * Rows * N);
+
+        Tensor<T, D...> result;
+        TensorUtils::with_contiguous(src, [&](const T *in) {
+            if constexpr (N <= Kernels::SmallThreshold)
             {
-                max = t[i];
-                max_idx = i;
+#pragma omp parallel for if (Rows * N >= Kernels::ParallelThreshold)
+                for (long r = 0; r < (long)Rows; r++)
+                    Kernels::Small<N>::softmax(in + r * N, result.data + r * N);
             }
-
-        return max_idx;
+            else
+                Kernels::softmax(in, result.data, Rows, N);
+        });
+        return result;
     }
 }
 
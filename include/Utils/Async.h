@@ -0,0 +1,304 @@
+#ifndef ASYNC_H_
+#define ASYNC_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // Coroutine tasks on a shared worker pool.
+    //
+    //   auto update = async([&]() { apply_gradients(); });
+    //   auto dx = other_work();       // overlaps with the update
+    //   update.get();                 // or co_await update inside a Task
+    //
+    // A Task starts when it is created and runs on a pool worker from its
+    // first co_await of ThreadPool::schedule(); async(f) does exactly that
+    // for a plain callable. Awaiting resumes the awaiting coroutine on the
+    // thread that finished the task; get() blocks instead, so it must not
+    // be called from inside a task (a single-worker pool would deadlock).
+    //
+    // Workers run kernels with one OpenMP thread each, as Hogwild workers
+    // do, so tasks share the cores with the caller's parallel regions
+    // instead of each spawning a full team.
+    // ------------------------------------------------------------------------
+
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Resumes `handle` on a worker.
+        void post(std::coroutine_handle<> handle);
+
+        // co_await pool.schedule() moves the coroutine onto a worker.
+        auto schedule()
+        {
+            struct Awaiter
+            {
+                ThreadPool &pool;
+
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> handle) { pool.post(handle); }
+                void await_resume() const noexcept {}
+            };
+            return Awaiter{*this};
+        }
+
+        size_t size() const
+        {
+            return workers.size();
+        }
+
+    private:
+        void run();
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::coroutine_handle<>> queue;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+    };
+
+    // The library pool, one worker per hardware thread, started on first use.
+    ThreadPool &thread_pool();
+
+    namespace Detail
+    {
+        // Completion handshake between a running task and its single
+        // consumer: Running, Done, or the address of the coroutine waiting
+        // for the result. The frame has two owners, the finished coroutine
+        // and the consumer; whichever lets go last destroys it, so a
+        // consumer woken by Done never frees it under the notifying thread.
+        struct TaskState
+        {
+            static constexpr uintptr_t Running = 0, Done = 1;
+
+            std::atomic<uintptr_t> state{Running};
+            std::atomic<int> owners{2};
+            std::exception_ptr error;
+
+            std::suspend_never initial_suspend() noexcept { return {}; }
+
+            auto final_suspend() noexcept
+            {
+                struct Awaiter
+                {
+                    TaskState &task;
+
+                    bool await_ready() const noexcept { return false; }
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<> self) noexcept
+                    {
+                        const uintptr_t waiting = task.state.exchange(Done, std::memory_order_acq_rel);
+                        task.state.notify_all();
+                        if (task.disown())
+                            self.destroy();
+                        if (waiting != Running)
+                            return std::coroutine_handle<>::from_address(reinterpret_cast<void *>(waiting));
+                        return std::noop_coroutine();
+                    }
+                    void await_resume() const noexcept {}
+                };
+                return Awaiter{*this};
+            }
+
+            // True for the last owner, which must destroy the frame.
+            bool disown()
+            {
+                return owners.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            }
+
+            void unhandled_exception()
+            {
+                error = std::current_exception();
+            }
+
+            // False if the task already finished and `waiting` should just
+            // continue.
+            bool suspend(std::coroutine_handle<> waiting)
+            {
+                uintptr_t expected = Running;
+                return state.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(waiting.address()),
+                                                     std::memory_order_acq_rel);
+            }
+
+            void wait() const
+            {
+                for (uintptr_t s = state.load(std::memory_order_acquire); s != Done; s = state.load(std::memory_order_acquire))
+                    state.wait(s, std::memory_order_acquire);
+            }
+
+            bool done() const
+            {
+                return state.load(std::memory_order_acquire) == Done;
+            }
+
+            void rethrow() const
+            {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        };
+
+        template <class T>
+        struct TaskResult : TaskState
+        {
+            void return_value(T value)
+            {
+                result.emplace(value);
+            }
+
+            // Hands the value out once; Tensor copies from a non-const
+            // lvalue take over the buffer.
+            T take()
+            {
+                rethrow();
+                T &value = *result;
+                return value;
+            }
+
+            std::optional<T> result;
+        };
+
+        template <>
+        struct TaskResult<void> : TaskState
+        {
+            void return_void() {}
+
+            void take()
+            {
+                rethrow();
+            }
+        };
+    }
+
+    template <class T = void>
+    class Task
+    {
+    public:
+        struct promise_type : Detail::TaskResult<T>
+        {
+            Task get_return_object()
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
+
+        Task() = default;
+
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        // Waits for a task still in flight, like a std::async future.
+        ~Task()
+        {
+            release();
+        }
+
+        bool valid() const
+        {
+            return (bool)handle;
+        }
+
+        bool done() const
+        {
+            return !handle || handle.promise().done();
+        }
+
+        void wait() const
+        {
+            if (handle)
+                handle.promise().wait();
+        }
+
+        // Blocks for the result and rethrows the task's exception; the task
+        // is empty afterwards.
+        T get()
+        {
+            wait();
+            Task finished = std::move(*this);
+            return finished.handle.promise().take();
+        }
+
+        auto operator co_await() &&
+        {
+            struct Awaiter
+            {
+                Task task;
+
+                bool await_ready() const noexcept { return task.done(); }
+                bool await_suspend(std::coroutine_handle<> waiting) { return task.handle.promise().suspend(waiting); }
+                T await_resume() { return task.handle.promise().take(); }
+            };
+            return Awaiter{std::move(*this)};
+        }
+
+        auto operator co_await() &
+        {
+            return std::move(*this).operator co_await();
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        void release()
+        {
+            if (!handle)
+                return;
+            handle.promise().wait();
+            if (handle.promise().disown())
+                handle.destroy();
+            handle = nullptr;
+        }
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    // Runs f() on `pool` and completes with its result.
+    template <class F>
+    Task<std::invoke_result_t<F &>> async(F f, ThreadPool &pool = thread_pool())
+    {
+        co_await pool.schedule();
+        co_return f();
+    }
+
+    // module.forward(input) / module.backward(delta, rate) as tasks. The
+    // arguments are used in place and must outlive the task.
+    template <class M, class X>
+    auto forward_async(M &module, const X &input)
+    {
+        return async([&module, &input]() { return module.forward(input); });
+    }
+
+    template <class M, class X>
+    auto backward_async(M &module, const X &delta, float learningRate)
+    {
+        return async([&module, &delta, learningRate]() { return module.backward(delta, learningRate); });
+    }
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef BATCH_DISPATCH_H_
+#define BATCH_DISPATCH_H_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "Tensor.h"
+#include "Utils/InferenceEngine.h"
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // Runtime row counts over a model compiled for a fixed set of batches.
+    //
+    //   BatchDispatch<AffineNet, Tensor<float, 784>, Tensor<float, 10>, 1, 8, 32> run(model);
+    //   auto rows = run.forward(samples.data, 45);   // 32 + 8 + 5 x 1
+    //   const float *scores = rows[44];
+    //
+    // `Model::forward<Batch>` is instantiated once per entry of `Batches`. A
+    // count is split into chunks of those sizes with the least padding, then
+    // the fewest calls; the plan for every remainder is a table built at
+    // compile time. Only a last chunk smaller than every batch is padded.
+    //
+    // The result does not copy the model's outputs: it keeps each chunk's
+    // output tensor alive and indexes the valid rows in place. Like a model,
+    // a BatchDispatch is not safe to call from several threads at once.
+    // ------------------------------------------------------------------------
+
+    template <class T, size_t... D>
+    class BatchRows
+    {
+    public:
+        static constexpr size_t RowSize = TensorUtils::get_size<D...>();
+
+        // A run of valid rows inside one chunk's output.
+        struct Segment
+        {
+            const T *data;
+            size_t rows;
+        };
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        // Row i, RowSize contiguous elements.
+        const T *operator[](size_t i) const
+        {
+            assert(i < count);
+            for (const auto &segment : parts)
+            {
+                if (i < segment.rows)
+                    return segment.data + i * RowSize;
+                i -= segment.rows;
+            }
+            return nullptr;
+        }
+
+        const std::vector<Segment> &segments() const
+        {
+            return parts;
+        }
+
+        // Takes over the first `rows` rows of `output`.
+        template <size_t Batch>
+        void append(Tensor<T, Batch, D...> &output, size_t rows)
+        {
+            auto owned = std::make_shared<Tensor<T, Batch, D...>>(output);
+            parts.push_back({owned->data, rows});
+            owners.push_back(std::move(owned));
+            count += rows;
+        }
+
+    private:
+        std::vector<Segment> parts;
+        std::vector<std::shared_ptr<const void>> owners;
+        size_t count = 0;
+    };
+
+    template <class Model, class Input, class Output, size_t... Batches>
+    class BatchDispatch
+    {
+        BatchDispatch() = delete;
+    };
+
+    template <class Model, class T, size_t... I, size_t... O, size_t... Batches>
+    class BatchDispatch<Model, Tensor<T, I...>, Tensor<T, O...>, Batches...>
+    {
+        static_assert(sizeof...(Batches) > 0, "At least one batch size is required");
+        static_assert(((Batches > 0) && ...), "Batch sizes must be positive");
+
+        static constexpr size_t InputSize = TensorUtils::get_size<I...>();
+        static constexpr size_t batch_sizes[] = {Batches...};
+        static constexpr size_t max_compiled_batch = std::max({Batches...});
+
+        static constexpr size_t min_compiled_batch = std::min({Batches...});
+
+        // Counts above Horizon first shed whole largest batches. Past
+        // (min - 1)(max - 1) every multiple of the batches' gcd splits
+        // exactly, so shedding never costs padding there.
+        static constexpr size_t Horizon = max_compiled_batch * (min_compiled_batch + 1);
+
+        struct Choice
+        {
+            size_t padding = 0;
+            size_t calls = 0;
+            size_t first = 0;
+        };
+
+        // First chunk of the best split of every count up to Horizon.
+        static constexpr std::array<size_t, Horizon + 1> plans = []() {
+            std::array<Choice, Horizon + 1> best{};
+            for (size_t r = 1; r <= Horizon; r++)
+            {
+                best[r] = {Horizon, Horizon, 0};
+                for (size_t b : batch_sizes)
+                {
+                    Choice c = b >= r ? Choice{b - r, 1, b} : Choice{best[r - b].padding, best[r - b].calls + 1, b};
+                    // Ties run the larger chunk first.
+                    if (std::tie(c.padding, c.calls) < std::tie(best[r].padding, best[r].calls) ||
+                        (std::tie(c.padding, c.calls) == std::tie(best[r].padding, best[r].calls) && b > best[r].first))
+                        best[r] = c;
+                }
+            }
+
+            std::array<size_t, Horizon + 1> first{};
+            for (size_t r = 0; r <= Horizon; r++)
+                first[r] = best[r].first;
+            return first;
+        }();
+
+    public:
+        using Rows = BatchRows<T, O...>;
+
+        explicit BatchDispatch(Model &model) : model(model) {}
+
+        // Chunk sizes, in the order forward() runs them, for `count` rows.
+        static std::vector<size_t> plan(size_t count)
+        {
+            std::vector<size_t> chunks;
+            for (; count > Horizon; count -= max_compiled_batch)
+                chunks.push_back(max_compiled_batch);
+            for (; count > 0; count -= std::min(count, plans[count]))
+                chunks.push_back(plans[count]);
+            return chunks;
+        }
+
+        // Runs `count` row-major samples of InputSize elements each.
+        Rows forward(const T *input, size_t count)
+        {
+            Rows result;
+            for (size_t chunk : plan(count))
+            {
+                const size_t rows = std::min(chunk, count - result.size());
+                ((chunk == Batches && (run<Batches>(input + result.size() * InputSize, rows, result), true)) || ...);
+            }
+            return result;
+        }
+
+        template <size_t N>
+        Rows forward(const Tensor<T, N, I...> &input, size_t count = N)
+        {
+            assert(count <= N);
+            return forward(input.data, count);
+        }
+
+        InferenceStats stats() const
+        {
+            return statistics;
+        }
+
+    private:
+        template <size_t Batch>
+        static constexpr size_t slot()
+        {
+            size_t i = 0;
+            while (batch_sizes[i] != Batch)
+                i++;
+            return i;
+        }
+
+        template <size_t Batch>
+        void run(const T *input, size_t rows, Rows &result)
+        {
+            // Rows past `rows` keep whatever the slot last held; they are
+            // computed and dropped.
+            auto &batch = std::get<slot<Batch>()>(staging);
+            Kernels::copy(input, batch.data, rows * InputSize);
+
+            Tensor<T, Batch, O...> output = model.template forward<Batch>(batch);
+            result.append(output, rows);
+
+            statistics.requests += rows;
+            statistics.batches++;
+            statistics.padded_rows += Batch - rows;
+        }
+
+        Model &model;
+        std::tuple<Tensor<T, Batches, I...>...> staging;
+        InferenceStats statistics;
+    };
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef HOGWILD_H_
+#define HOGWILD_H_
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Module.h"
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // Lock-free asynchronous (Hogwild) training.
+    //
+    // `threads` workers pull step indices from a shared counter and call
+    // `step(i)`, which runs forward/backward on one batch of the shared
+    // model. Each worker gets its own memory lane, so saved activations
+    // never alias, and runs its kernels single-threaded; the lanes and what
+    // they saved are freed once all steps are done. Weight updates are
+    // plain unsynchronized stores to the shared parameters: concurrent
+    // updates to the same weight may be lost, never torn, which is the
+    // bounded staleness Hogwild relies on for small or sparse models.
+    //
+    // With one thread this is the synchronous path: steps run in order on
+    // the calling thread with OpenMP-parallel kernels.
+    // ------------------------------------------------------------------------
+
+    template <class T, class Step>
+    void train_hogwild(Module<T> &model, size_t threads, size_t steps, Step &&step)
+    {
+        if (threads <= 1)
+        {
+            for (size_t i = 0; i < steps; i++)
+                step(i);
+            return;
+        }
+
+        model.reserve_lanes(threads);
+        const uint64_t keys = Random::reserve_thread_keys(threads);
+        std::atomic<size_t> next(0);
+
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < threads; w++)
+            workers.emplace_back([&, w]() {
+#ifdef _OPENMP
+                omp_set_num_threads(1);
+#endif
+                memory_lane() = w;
+                Random::thread_index() = keys + w;
+                for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < steps;
+                     i = next.fetch_add(1, std::memory_order_relaxed))
+                    step(i);
+            });
+
+        for (auto &worker : workers)
+            worker.join();
+        model.release_lanes();
+    }
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef INFERENCE_ENGINE_H_
+#define INFERENCE_ENGINE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Tensor.h"
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // In-process inference engine with dynamic micro-batching.
+    //
+    // Single-sample requests are queued and coalesced into one of the
+    // precompiled batch sizes before being run through `Model::forward<Batch>`.
+    // `max_delay` bounds how long the oldest queued request may wait for more
+    // work to arrive (p99 latency), `max_batch` caps the coalesced batch
+    // (throughput) and must admit at least one compiled batch size, else the
+    // constructor throws std::invalid_argument.
+    // ------------------------------------------------------------------------
+
+    struct InferenceOptions
+    {
+        std::chrono::microseconds max_delay = std::chrono::microseconds(2000);
+        size_t max_batch = 0;
+    };
+
+    struct InferenceStats
+    {
+        size_t requests = 0;
+        size_t batches = 0;
+        size_t padded_rows = 0;
+    };
+
+    template <class Model, class Input, class Output, size_t... Batches>
+    class InferenceEngine
+    {
+        InferenceEngine() = delete;
+    };
+
+    template <class Model, class T, size_t... I, size_t... O, size_t... Batches>
+    class InferenceEngine<Model, Tensor<T, I...>, Tensor<T, O...>, Batches...>
+    {
+        static_assert(sizeof...(Batches) > 0, "At least one batch size is required");
+
+        using Clock = std::chrono::steady_clock;
+        using Sample = Tensor<T, I...>;
+        using Result = Tensor<T, O...>;
+
+        static constexpr size_t batch_sizes[] = {Batches...};
+        static constexpr size_t max_compiled_batch = std::max({Batches...});
+
+        struct Request
+        {
+            Request(const Sample &input) : input(input), arrival(Clock::now()) {}
+
+            Sample input;
+            std::promise<Result> result;
+            Clock::time_point arrival;
+        };
+
+    public:
+        InferenceEngine(Model &model, InferenceOptions options = InferenceOptions())
+            : model(model), options(options)
+        {
+            if (this->options.max_batch == 0 || this->options.max_batch > max_compiled_batch)
+                this->options.max_batch = max_compiled_batch;
+            if (!select_batch(1, this->options.max_batch))
+                throw std::invalid_argument("InferenceEngine: no compiled batch size within max_batch");
+
+            worker = std::thread([this]() { run(); });
+        }
+
+        ~InferenceEngine()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            worker.join();
+        }
+
+        std::future<Result> submit(const Sample &input)
+        {
+            std::future<Result> future;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.emplace_back(input);
+                future = pending.back().result.get_future();
+            }
+            wake.notify_one();
+            return future;
+        }
+
+        InferenceStats stats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return statistics;
+        }
+
+        // Smallest compiled batch not exceeding `limit` that holds `count`
+        // requests, or the largest one not exceeding `limit` when none does
+        // (the rest stay queued for the next batch). 0 if every compiled
+        // batch exceeds `limit`.
+        static size_t select_batch(size_t count, size_t limit)
+        {
+            size_t fit = 0, below = 0;
+            for (size_t b : batch_sizes)
+            {
+                if (b > limit)
+                    continue;
+                if (b >= count && (fit == 0 || b < fit))
+                    fit = b;
+                if (b <= count && b > below)
+                    below = b;
+            }
+
+            return fit ? fit : below;
+        }
+
+    private:
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+                if (pending.empty())
+                    return;
+
+                auto deadline = pending.front().arrival + options.max_delay;
+                wake.wait_until(lock, deadline, [this]() {
+                    return stopping || pending.size() >= options.max_batch;
+                });
+
+                size_t batch = select_batch(std::min(pending.size(), options.max_batch), options.max_batch);
+                if (!batch)
+                {
+                    fail_pending();
+                    continue;
+                }
+                ((batch == Batches && (dispatch<Batches>(lock), true)) || ...);
+            }
+        }
+
+        // Nothing can run the queue; resolve every request with an error
+        // rather than leave it waiting.
+        void fail_pending()
+        {
+            auto error = std::make_exception_ptr(std::logic_error("InferenceEngine: no compiled batch size within max_batch"));
+            for (auto &request : pending)
+                request.result.set_exception(error);
+            pending.clear();
+        }
+
+        template <size_t Batch>
+        void dispatch(std::unique_lock<std::mutex> &lock)
+        {
+            size_t count = std::min(pending.size(), Batch);
+
+            Tensor<T, Batch, I...> input;
+            std::vector<std::promise<Result>> promises;
+            promises.reserve(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                input[i] = pending.front().input;
+                promises.push_back(std::move(pending.front().result));
+                pending.pop_front();
+            }
+
+            statistics.requests += count;
+            statistics.batches++;
+            statistics.padded_rows += Batch - count;
+
+            lock.unlock();
+            size_t done = 0;
+            try
+            {
+                Tensor<T, Batch, O...> output = model.template forward<Batch>(input);
+                for (; done < count; done++)
+                    promises[done].set_value(output[done]);
+            }
+            catch (...)
+            {
+                for (size_t i = done; i < count; i++)
+                    promises[i].set_exception(std::current_exception());
+            }
+            lock.lock();
+        }
+
+        Model &model;
+        InferenceOptions options;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<Request> pending;
+        InferenceStats statistics;
+        bool stopping = false;
+
+        std::thread worker;
+    };
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef NUMA_H_
+#define NUMA_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace StaticNet
+{
+    namespace Numa
+    {
+        // ------------------------------------------------------------
+        // NUMA placement of tensor memory and CPU affinity of workers.
+        //
+        // Every tensor allocation of at least PlacementThreshold bytes
+        // follows the calling thread's policy, set with a Scope:
+        //
+        //   FirstTouch  kernel default, pages land where first written;
+        //               Tensor fills large buffers with a static OpenMP
+        //               schedule so they start next to their consumers
+        //   Interleave  pages round-robin over all nodes, e.g. weights
+        //               shared by every socket
+        //   Node        pages on one node, e.g. activations of a worker
+        //               pinned there
+        //
+        // Uses the mbind/sched_setaffinity syscalls directly on Linux
+        // (no libnuma); elsewhere everything is a no-op on one node.
+        // ------------------------------------------------------------
+
+        enum class Placement
+        {
+            FirstTouch = 0,
+            Interleave = 1,
+            Node = 2
+        };
+
+        struct Policy
+        {
+            Placement placement = Placement::FirstTouch;
+            int node = 0;
+        };
+
+        constexpr size_t PlacementThreshold = 1 << 16;
+
+        inline Policy &policy()
+        {
+            thread_local Policy current;
+            return current;
+        }
+
+        // Sets the calling thread's policy until the end of the scope.
+        class Scope
+        {
+        public:
+            Scope(Policy next) : previous(policy()) { policy() = next; }
+            ~Scope() { policy() = previous; }
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            Policy previous;
+        };
+
+        // Online nodes and their CPUs, from sysfs (one node with every CPU
+        // when unavailable).
+        size_t nodes();
+        std::vector<int> cpus(int node);
+        std::vector<int> parse_cpulist(const std::string &list);
+
+        // Applies `policy` to the pages fully inside [data, data + bytes),
+        // moving those already resident. Returns false when the kernel
+        // refused or placement is unsupported.
+        bool bind(void *data, size_t bytes, const Policy &policy);
+
+        // Node holding the page at `address`, -1 when unknown.
+        int node_of(const void *address);
+
+        inline void place(void *data, size_t bytes)
+        {
+            const Policy &current = policy();
+            if (current.placement != Placement::FirstTouch && bytes >= PlacementThreshold)
+                bind(data, bytes, current);
+        }
+
+        // Restricts the calling thread to `cpus`. Returns false on failure.
+        bool pin_current_thread(const std::vector<int> &cpus);
+
+        // Pins the OpenMP team: Compact fills node 0 first, Spread deals
+        // threads round-robin over nodes. Returns how many were pinned.
+        enum class Affinity
+        {
+            Compact = 0,
+            Spread = 1
+        };
+
+        size_t pin_omp_threads(Affinity affinity);
+    }
+}
+
+#endif
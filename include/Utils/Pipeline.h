@@ -0,0 +1,336 @@
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Module.h"
+#include "Utils/Numa.h"
+
+namespace StaticNet
+{
+    // ------------------------------------------------------------------------
+    // Bounded lock-free single-producer/single-consumer ring. `Capacity`
+    // must be a power of two; push/pop spin with a yield when full/empty.
+    // ------------------------------------------------------------------------
+
+    template <class Item, size_t Capacity>
+    class SpscQueue
+    {
+        static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    public:
+        bool try_push(Item &item)
+        {
+            const size_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail - head.load(std::memory_order_acquire) == Capacity)
+                return false;
+            slots[tail & (Capacity - 1)] = std::move(item);
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(Item &item)
+        {
+            const size_t head = this->head.load(std::memory_order_relaxed);
+            if (head == tail.load(std::memory_order_acquire))
+                return false;
+            item = std::move(slots[head & (Capacity - 1)]);
+            this->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        void push(Item item)
+        {
+            while (!try_push(item))
+                std::this_thread::yield();
+        }
+
+        Item pop()
+        {
+            Item item;
+            while (!try_pop(item))
+                std::this_thread::yield();
+            return item;
+        }
+
+    private:
+        std::array<Item, Capacity> slots;
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+    };
+
+    // ------------------------------------------------------------------------
+    // Pipeline-parallel executor over a chain of stage modules.
+    //
+    // Each stage runs on its own thread (optionally pinned to a core group,
+    // with that many OpenMP threads) and a batch is split into micro-batches
+    // of `Micro` rows that stream through bounded SPSC queues.
+    //
+    //   forward  plain pipelining, nothing is saved for backward.
+    //   train    1F1B schedule: stage s runs S - s - 1 warm-up forwards,
+    //            then alternates one backward and one forward. At most S
+    //            micro-batches are in flight per stage, so micro-batch m
+    //            keeps its activations in memory lane m % S.
+    //
+    // Each micro-batch applies its own update scaled by Micro / Batch, so
+    // one train() call takes the same step as a full-batch backward, up to
+    // the weights moving between micro-batches (no weight stashing).
+    // ------------------------------------------------------------------------
+
+    struct PipelineOptions
+    {
+        // Cores per stage, e.g. Numa::cpus(node); an empty or missing group
+        // leaves the stage unpinned with a single OpenMP thread.
+        std::vector<std::vector<int>> cores;
+    };
+
+    template <class T, size_t Micro, class... Stages>
+    class Pipeline
+    {
+        static constexpr size_t Count = sizeof...(Stages);
+        static_assert(Count > 0, "Pipeline needs at least one stage");
+
+        // Micro-batch tensors between stages: X_0 is the input, X_s the
+        // output of stage s - 1.
+        template <class X, class... S>
+        struct activations
+        {
+            using type = std::tuple<X>;
+        };
+
+        template <class X, class S, class... Rest>
+        struct activations<X, S, Rest...>
+        {
+            using Y = decltype(std::declval<S &>().template forward<Micro>(std::declval<const X &>()));
+            using type = decltype(std::tuple_cat(std::declval<std::tuple<X>>(), std::declval<typename activations<Y, Rest...>::type>()));
+        };
+
+        template <class X>
+        struct elements;
+
+        template <size_t... D>
+        struct elements<Tensor<T, D...>>
+        {
+            static constexpr size_t value = TensorUtils::get_size<D...>();
+        };
+
+        template <class X, size_t Batch>
+        struct rebatch;
+
+        template <size_t M, size_t... D, size_t Batch>
+        struct rebatch<Tensor<T, M, D...>, Batch>
+        {
+            using type = Tensor<T, Batch, D...>;
+        };
+
+        static constexpr size_t QueueCapacity = std::bit_ceil(Count + 1);
+
+        template <class X>
+        using Queue = SpscQueue<std::unique_ptr<X>, QueueCapacity>;
+
+        template <class Tuple, size_t... I>
+        static auto queues_of(std::index_sequence<I...>) -> std::tuple<Queue<std::tuple_element_t<I + 1, Tuple>>...>;
+
+    public:
+        Pipeline(Stages &...stages, PipelineOptions options = PipelineOptions())
+            : stages(stages...), options(options)
+        {
+        }
+
+        template <size_t Batch, size_t... D>
+        auto forward(const Tensor<T, Batch, D...> &input)
+        {
+            auto result = run<Batch, false>(input, [](size_t, auto &) { return nullptr; }, 0.0f);
+            return std::remove_reference_t<decltype(*result.first)>(*result.first);
+        }
+
+        // `loss(m, output)` returns the gradient of micro-batch m's output
+        // rows [m * Micro, (m + 1) * Micro). Returns the input gradient.
+        template <size_t Batch, size_t... D, class Loss>
+        Tensor<T, Batch, D...> train(const Tensor<T, Batch, D...> &input, Loss &&loss, float learningRate)
+        {
+            auto result = run<Batch, true>(input, loss, learningRate);
+            return Tensor<T, Batch, D...>(*result.second);
+        }
+
+    private:
+        template <size_t Batch, bool Training, size_t... D, class Loss>
+        auto run(const Tensor<T, Batch, D...> &input, Loss &&loss, float learningRate)
+        {
+            static_assert(Batch % Micro == 0, "Pipeline batch must be a multiple of the micro-batch");
+            using Activations = typename activations<Tensor<T, Micro, D...>, Stages...>::type;
+            using Output = typename rebatch<std::tuple_element_t<Count, Activations>, Batch>::type;
+            using Queues = decltype(queues_of<Activations>(std::make_index_sequence<Count - 1>()));
+
+            auto result = std::make_pair(std::make_unique<Output>(), std::make_unique<Tensor<T, Batch, D...>>());
+            auto forward_queues = std::make_unique<Queues>();
+            auto backward_queues = std::make_unique<Queues>();
+
+            if constexpr (Training)
+                std::apply([](auto &...stage) { (stage.reserve_lanes(Count), ...); }, stages);
+
+            Context<Batch, Activations, Queues, Output, Tensor<T, Batch, D...>, std::remove_reference_t<Loss>> context{
+                input, *result.first, *result.second, *forward_queues, *backward_queues, loss,
+                (float)(learningRate * Micro / Batch)};
+
+            launch<Training>(context, std::make_index_sequence<Count>());
+            if constexpr (Training)
+                std::apply([](auto &...stage) { (stage.release_lanes(), ...); }, stages);
+            return result;
+        }
+
+        template <size_t Batch, class Activations, class Queues, class Output, class Input, class Loss>
+        struct Context
+        {
+            static constexpr size_t batch = Batch;
+            using activations = Activations;
+
+            const Input &input;
+            Output &output;
+            Input &gradient;
+            Queues &forward;
+            Queues &backward;
+            Loss &loss;
+            float rate;
+        };
+
+        template <bool Training, class Context, size_t... S>
+        void launch(Context &context, std::index_sequence<S...>)
+        {
+            const uint64_t keys = Random::reserve_thread_keys(Count);
+            std::array<std::thread, Count> workers = {std::thread([this, &context, keys]() {
+                pin(S);
+                Random::thread_index() = keys + S;
+                if constexpr (Training)
+                    train_stage<S>(context);
+                else
+                    forward_stage<S>(context);
+            })...};
+
+            for (auto &worker : workers)
+                worker.join();
+        }
+
+        void pin(size_t stage)
+        {
+            const std::vector<int> none;
+            const auto &group = stage < options.cores.size() ? options.cores[stage] : none;
+#ifdef _OPENMP
+            omp_set_num_threads(std::max<int>(1, (int)group.size()));
+#endif
+            if (!group.empty())
+                Numa::pin_current_thread(group);
+        }
+
+        // Input of stage S for the next micro-batch m.
+        template <size_t S, class Context>
+        std::unique_ptr<std::tuple_element_t<S, typename Context::activations>> receive(Context &context, size_t m)
+        {
+            using X = std::tuple_element_t<S, typename Context::activations>;
+            if constexpr (S == 0)
+            {
+                constexpr size_t Size = elements<X>::value;
+                auto x = std::make_unique<X>();
+                std::copy(context.input.data + m * Size, context.input.data + (m + 1) * Size, x->data);
+                return x;
+            }
+            else
+                return std::get<S - 1>(context.forward).pop();
+        }
+
+        template <size_t S, class Context>
+        void forward_stage(Context &context)
+        {
+            auto &stage = std::get<S>(stages);
+            stage.record(false);
+            for (size_t m = 0; m < Context::batch / Micro; m++)
+            {
+                auto x = receive<S>(context, m);
+                auto y = stage.template forward<Micro>(*x);
+                emit<S>(context, m, y);
+            }
+            stage.record(true);
+        }
+
+        // Output of stage S for micro-batch m: to the next stage, or into
+        // the result batch.
+        template <size_t S, class Context, class Y>
+        void emit(Context &context, size_t m, Y &y)
+        {
+            if constexpr (S + 1 == Count)
+            {
+                constexpr size_t Size = elements<Y>::value;
+                std::copy(y.data, y.data + Size, context.output.data + m * Size);
+            }
+            else
+                std::get<S>(context.forward).push(std::make_unique<Y>(y));
+        }
+
+        template <size_t S, class Context>
+        void train_stage(Context &context)
+        {
+            using Y = std::tuple_element_t<S + 1, typename Context::activations>;
+            constexpr size_t Micros = Context::batch / Micro;
+            auto &stage = std::get<S>(stages);
+
+            std::vector<std::unique_ptr<Y>> deltas;
+            size_t forwards = 0, backwards = 0;
+
+            auto forward = [&]() {
+                const size_t m = forwards++;
+                memory_lane() = m % Count;
+                auto x = receive<S>(context, m);
+                auto y = stage.template forward<Micro>(*x);
+                if constexpr (S + 1 == Count)
+                    deltas.push_back(std::make_unique<Y>(context.loss(m, y)));
+                emit<S>(context, m, y);
+            };
+
+            auto backward = [&]() {
+                const size_t m = backwards++;
+                memory_lane() = m % Count;
+                std::unique_ptr<Y> delta;
+                if constexpr (S + 1 == Count)
+                    delta = std::move(deltas[m]);
+                else
+                    delta = std::get<S>(context.backward).pop();
+
+                auto dx = stage.template backward<Micro>(*delta, context.rate);
+                if constexpr (S == 0)
+                {
+                    constexpr size_t Size = elements<decltype(dx)>::value;
+                    std::copy(dx.data, dx.data + Size, context.gradient.data + m * Size);
+                }
+                else
+                    std::get<S - 1>(context.backward).push(std::make_unique<decltype(dx)>(dx));
+            };
+
+            for (size_t i = 0; i < std::min(Count - S - 1, Micros); i++)
+                forward();
+            while (backwards < Micros)
+            {
+                if (forwards < Micros)
+                    forward();
+                backward();
+            }
+            memory_lane() = 0;
+        }
+
+        std::tuple<Stages &...> stages;
+        PipelineOptions options;
+    };
+}
+
+#endif
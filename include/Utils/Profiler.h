@@ -0,0 +1,236 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace StaticNet
+{
+    namespace Profiler
+    {
+        // ------------------------------------------------------------
+        // Opt-in hot-path instrumentation.
+        //
+        // Compiled in with STATICNET_PROFILE and switched on at runtime with
+        // enable(). Kernel counters are thread-local and merged on read;
+        // module counters live on the Module and are inclusive of the kernels
+        // and child modules they call. Counters should be read while no
+        // module is running.
+        // ------------------------------------------------------------
+
+        struct Counters
+        {
+            uint64_t calls = 0;
+            uint64_t ticks = 0;
+            uint64_t flops = 0;
+            uint64_t bytes = 0;
+            uint64_t allocations = 0;
+            uint64_t allocated_bytes = 0;
+
+            Counters &operator+=(const Counters &other);
+        };
+
+        struct SharedCounters
+        {
+            std::atomic<uint64_t> calls{0};
+            std::atomic<uint64_t> ticks{0};
+            std::atomic<uint64_t> flops{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> allocated_bytes{0};
+
+            void add(const Counters &counters);
+            Counters load() const;
+            void reset();
+        };
+
+        struct ModuleCounters
+        {
+            SharedCounters forward;
+            SharedCounters backward;
+        };
+
+        struct TraceEvent
+        {
+            std::string name;
+            const char *category;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        struct ThreadState
+        {
+            ThreadState();
+            ~ThreadState();
+
+            // Running totals on this thread, sampled by scopes.
+            uint64_t flops = 0;
+            uint64_t bytes = 0;
+            uint64_t allocations = 0;
+            uint64_t allocated_bytes = 0;
+
+            size_t tid = 0;
+            std::vector<Counters> kernels;
+            std::vector<TraceEvent> events;
+        };
+
+        inline std::atomic<bool> active{false};
+        inline std::atomic<bool> tracing{false};
+
+        inline ThreadState &thread_state()
+        {
+            thread_local ThreadState state;
+            return state;
+        }
+
+        inline uint64_t ticks()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+#endif
+        }
+
+        inline bool enabled()
+        {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        void enable(bool trace = false);
+        void disable();
+        void reset();
+
+        double ticks_to_seconds(uint64_t ticks);
+
+        size_t register_kernel(const char *name);
+        std::vector<std::pair<std::string, Counters>> kernels();
+
+        std::string format(const Counters &counters);
+        void print_kernels(std::ostream &os = std::cout);
+        void write_chrome_trace(std::ostream &os);
+        bool write_chrome_trace(const std::string &path);
+
+        inline void count_allocation(size_t bytes)
+        {
+            if (enabled())
+            {
+                ThreadState &state = thread_state();
+                state.allocations++;
+                state.allocated_bytes += bytes;
+            }
+        }
+
+        class Scope
+        {
+        public:
+            Scope(uint64_t flops, uint64_t bytes)
+                : running(enabled())
+            {
+                if (!running)
+                    return;
+
+                ThreadState &state = thread_state();
+                start.flops = state.flops;
+                start.bytes = state.bytes;
+                start.allocations = state.allocations;
+                start.allocated_bytes = state.allocated_bytes;
+                state.flops += flops;
+                state.bytes += bytes;
+                start.ticks = ticks();
+            }
+
+        protected:
+            Counters finish(ThreadState &state, uint64_t end) const
+            {
+                Counters counters;
+                counters.calls = 1;
+                counters.ticks = end - start.ticks;
+                counters.flops = state.flops - start.flops;
+                counters.bytes = state.bytes - start.bytes;
+                counters.allocations = state.allocations - start.allocations;
+                counters.allocated_bytes = state.allocated_bytes - start.allocated_bytes;
+                return counters;
+            }
+
+            void trace(ThreadState &state, std::string name, const char *category, uint64_t end) const
+            {
+                if (tracing.load(std::memory_order_relaxed))
+                    state.events.push_back({std::move(name), category, start.ticks, end});
+            }
+
+            bool running;
+            Counters start;
+        };
+
+        class KernelScope : public Scope
+        {
+        public:
+            KernelScope(size_t id, const char *name, uint64_t flops = 0, uint64_t bytes = 0)
+                : Scope(flops, bytes), id(id), name(name) {}
+
+            ~KernelScope()
+            {
+                if (!running)
+                    return;
+
+                uint64_t end = ticks();
+                ThreadState &state = thread_state();
+                if (state.kernels.size() <= id)
+                    state.kernels.resize(id + 1);
+                state.kernels[id] += finish(state, end);
+                trace(state, name, "kernel", end);
+            }
+
+        private:
+            size_t id;
+            const char *name;
+        };
+
+        class ModuleScope : public Scope
+        {
+        public:
+            ModuleScope(SharedCounters &counters, const std::string &name, const char *phase)
+                : Scope(0, 0), counters(counters), name(name), phase(phase) {}
+
+            ~ModuleScope()
+            {
+                if (!running)
+                    return;
+
+                uint64_t end = ticks();
+                ThreadState &state = thread_state();
+                counters.add(finish(state, end));
+                trace(state, name + "::" + phase, "module", end);
+            }
+
+        private:
+            SharedCounters &counters;
+            const std::string &name;
+            const char *phase;
+        };
+    }
+}
+
+#ifdef STATICNET_PROFILE
+#define STATICNET_PROFILE_KERNEL(name, ...)                                                  \
+    static const size_t staticnet_kernel_id = ::StaticNet::Profiler::register_kernel(name); \
+    ::StaticNet::Profiler::KernelScope staticnet_kernel_scope(staticnet_kernel_id, name, __VA_ARGS__)
+#define STATICNET_PROFILE_MODULE(phase) \
+    ::StaticNet::Profiler::ModuleScope staticnet_module_scope(this->profile.phase, this->name, #phase)
+#else
+#define STATICNET_PROFILE_KERNEL(name, ...) ((void)0)
+#define STATICNET_PROFILE_MODULE(phase) ((void)0)
+#endif
+
+#endif
@@ -1,16 +1,191 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
-#include <random>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "Kernels/Random.h"
 
 namespace StaticNet {
     namespace Random {
-        static std::random_device rd;
-        static std::mt19937 mt(rd());
+        // ------------------------------------------------------------
+        // Seeded, counter-based randomness (Philox4x32-10).
+        //
+        // One process-wide seed; every bulk fill draws a fresh stream id
+        // in call order, so results depend only on the seed and on the
+        // order of those calls, never on the number of threads or on scalar
+        // rand<T>() draws made in between. Generator is a
+        // cheap sequential view of one stream for scalar draws, and
+        // split() derives independent child streams, e.g. per worker.
+        // ------------------------------------------------------------
+
+        constexpr uint64_t DefaultSeed = 0x5EED5EED5EED5EEDull;
+
+        inline std::atomic<uint64_t> global_seed{DefaultSeed};
+        inline std::atomic<uint64_t> streams{0};
+        inline std::atomic<uint64_t> epoch{0};
+        inline std::atomic<uint64_t> worker_keys{0};
+        inline std::atomic<uint64_t> implicit_keys{0};
+
+        // Restarts every sequence from `value`.
+        inline void seed(uint64_t value)
+        {
+            global_seed = value;
+            streams = 0;
+            worker_keys = 0;
+            implicit_keys = 0;
+            epoch++;
+        }
+
+        inline uint64_t next_stream()
+        {
+            return streams.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline float to_unit_float(uint32_t word)
+        {
+            return (word >> 8) * (1.0f / 16777216.0f);
+        }
+
+        inline double to_unit_double(uint32_t word)
+        {
+            return word * (1.0 / 4294967296.0);
+        }
+
+        class Generator
+        {
+        public:
+            Generator(uint64_t stream = next_stream(), uint64_t seed = global_seed)
+                : seed(seed), stream(stream) {}
+
+            uint32_t next()
+            {
+                if (used == 4)
+                {
+                    Kernels::philox_words(words, 4 * block++, 4, seed, stream);
+                    used = 0;
+                }
+                return words[used++];
+            }
+
+            // Child stream i, independent of this one and of other children.
+            Generator split(uint64_t i) const
+            {
+                uint32_t c0 = (uint32_t)i, c1 = (uint32_t)(i >> 32), c2 = (uint32_t)stream, c3 = (uint32_t)(stream >> 32);
+                Kernels::philox4x32(c0, c1, c2, c3, (uint32_t)~seed, (uint32_t)(~seed >> 32));
+                return Generator(((uint64_t)c1 << 32 | c0) | 1ull << 63, seed);
+            }
+
+            float uniform(float lo = 0.0f, float hi = 1.0f) { return lo + (hi - lo) * to_unit_float(next()); }
+            double uniform(double lo, double hi) { return lo + (hi - lo) * to_unit_double(next()); }
+            bool bernoulli(double p) { return to_unit_double(next()) < p; }
+
+            // Uniform integer in [0, n) (Lemire's multiply-shift).
+            uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)next() * n) >> 32); }
+
+        private:
+            uint64_t seed, stream;
+            uint64_t block = 0;
+            uint32_t words[4] = {};
+            int used = 4;
+        };
+
+        // ------------------------------------------------------------
+        // Bulk fills, parallel and SIMD-batched.
+        // ------------------------------------------------------------
+
+        template <class T>
+        void uniform(T *out, size_t n, T lo, T hi, uint64_t stream = next_stream())
+        {
+            Kernels::philox_generate(out, n, global_seed, stream, [lo, hi](const uint32_t *words, T *dst, size_t count) {
+#pragma omp simd
+                for (size_t i = 0; i < count; i++)
+                    dst[i] = lo + (hi - lo) * (T)to_unit_float(words[i]);
+            });
+        }
+
+        // Box-Muller over word pairs.
+        template <class T>
+        void normal(T *out, size_t n, T mean, T stddev, uint64_t stream = next_stream())
+        {
+            Kernels::philox_generate(out, n, global_seed, stream, [mean, stddev](const uint32_t *words, T *dst, size_t count) {
+                for (size_t i = 0; i < count; i += 2)
+                {
+                    const float u = 1.0f - to_unit_float(words[i]);
+                    const float v = to_unit_float(words[i + 1]);
+                    const float r = std::sqrt(-2.0f * std::log(u));
+                    dst[i] = mean + stddev * (T)(r * std::cos(6.28318530718f * v));
+                    if (i + 1 < count)
+                        dst[i + 1] = mean + stddev * (T)(r * std::sin(6.28318530718f * v));
+                }
+            });
+        }
+
+        // 1 with probability p, else 0, e.g. dropout keep masks.
+        template <class T>
+        void bernoulli(T *out, size_t n, double p, uint64_t stream = next_stream())
+        {
+            const uint64_t threshold = (uint64_t)(p * 4294967296.0);
+            Kernels::philox_generate(out, n, global_seed, stream, [threshold](const uint32_t *words, T *dst, size_t count) {
+#pragma omp simd
+                for (size_t i = 0; i < count; i++)
+                    dst[i] = (T)((uint64_t)words[i] < threshold);
+            });
+        }
+
+        // The default distribution of rand<T>() over a buffer. Integral types
+        // have none; use uniform() or bernoulli() with explicit bounds.
+        template <class T>
+        void fill(T *out, size_t n, uint64_t stream = next_stream())
+        {
+            static_assert(std::is_floating_point_v<T> || std::is_same_v<T, bool>, "No default random distribution for this type");
+            if constexpr (std::is_same_v<T, bool>)
+                bernoulli(out, n, 0.5, stream);
+            else if constexpr (std::is_floating_point_v<T> && !std::is_same_v<T, float>)
+                uniform(out, n, T(0), T(1), stream);
+            else
+                uniform(out, n, T(-0.25), T(0.25), stream);
+        }
+
+        // Fisher-Yates over [first, last).
+        template <class It>
+        void shuffle(It first, It last, Generator generator = Generator())
+        {
+            for (auto i = std::distance(first, last) - 1; i > 0; i--)
+                std::swap(first[i], first[generator.below((uint32_t)i + 1)]);
+        }
+
+        // Key of the calling thread's scalar stream (see rand<T>()). Pools
+        // that start workers together take fresh keys for each run with
+        // reserve_thread_keys(), as Utils/Hogwild.h does, so every run
+        // draws new numbers in an order fixed by the seed. A thread that
+        // leaves it unset gets a unique key of its own on its first draw
+        // after each seed(), from a separate range.
+        constexpr uint64_t UnsetThreadIndex = ~0ull;
+        constexpr uint64_t ImplicitThreadKeys = 1ull << 62;
+
+        inline uint64_t &thread_index()
+        {
+            thread_local uint64_t index = UnsetThreadIndex;
+            return index;
+        }
+
+        // First of `count` keys no other run has used since the last seed().
+        inline uint64_t reserve_thread_keys(uint64_t count)
+        {
+            return worker_keys.fetch_add(count, std::memory_order_relaxed);
+        }
 
+        // Scalar draws from a per-thread stream: float in [-0.25, 0.25),
+        // double in [0, 1), bool fair. The stream depends only on the seed
+        // and the thread's key, never on the bulk fills' stream counter.
         template <class T>
         T rand();
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,63 @@
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Utils/Async.h"
+
+namespace StaticNet
+{
+    ThreadPool::ThreadPool(size_t threads)
+    {
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; i++)
+            workers.emplace_back([this]() { run(); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::post(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(handle);
+        }
+        wake.notify_one();
+    }
+
+    void ThreadPool::run()
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(1);
+#endif
+        for (;;)
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                handle = queue.front();
+                queue.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    ThreadPool &thread_pool()
+    {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Utils/Numa.h"
+
+namespace StaticNet
+{
+    namespace Numa
+    {
+        namespace
+        {
+            // From <linux/mempolicy.h>.
+            constexpr int MpolPreferred = 1;
+            constexpr int MpolInterleave = 3;
+            constexpr unsigned MpolMfMove = 1 << 1;
+            constexpr unsigned long MpolFNode = 1 << 0, MpolFAddr = 1 << 1;
+
+            std::string read_line(const std::string &path)
+            {
+                std::ifstream file(path);
+                std::string line;
+                std::getline(file, line);
+                return line;
+            }
+
+            std::vector<int> all_cpus()
+            {
+                std::vector<int> result(std::max(1u, std::thread::hardware_concurrency()));
+                for (size_t i = 0; i < result.size(); i++)
+                    result[i] = (int)i;
+                return result;
+            }
+        }
+
+        std::vector<int> parse_cpulist(const std::string &list)
+        {
+            std::vector<int> result;
+            std::stringstream stream(list);
+            std::string range;
+            while (std::getline(stream, range, ','))
+            {
+                if (range.empty())
+                    continue;
+                size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; cpu++)
+                    result.push_back(cpu);
+            }
+            return result;
+        }
+
+        size_t nodes()
+        {
+            static const size_t count = []() {
+                auto online = parse_cpulist(read_line("/sys/devices/system/node/online"));
+                return online.empty() ? (size_t)1 : (size_t)(*std::max_element(online.begin(), online.end()) + 1);
+            }();
+            return count;
+        }
+
+        std::vector<int> cpus(int node)
+        {
+            auto result = parse_cpulist(read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+            if (result.empty() && node == 0)
+                return all_cpus();
+            return result;
+        }
+
+        bool bind(void *data, size_t bytes, const Policy &policy)
+        {
+#if defined(__linux__) && defined(SYS_mbind)
+            const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+            const size_t begin = ((size_t)data + page - 1) / page * page;
+            const size_t end = ((size_t)data + bytes) / page * page;
+            if (end <= begin || policy.placement == Placement::FirstTouch)
+                return false;
+
+            unsigned long mask[16] = {};
+            const size_t max_node = sizeof(mask) * 8;
+            int mode;
+            if (policy.placement == Placement::Interleave)
+            {
+                mode = MpolInterleave;
+                for (size_t node = 0; node < std::min(nodes(), max_node); node++)
+                    mask[node / 64] |= 1ul << (node % 64);
+            }
+            else
+            {
+                if (policy.node < 0 || (size_t)policy.node >= max_node)
+                    return false;
+                mode = MpolPreferred;
+                mask[policy.node / 64] |= 1ul << (policy.node % 64);
+            }
+
+            // Buffers recycled from the heap are usually resident already, so
+            // their pages are moved rather than only new faults following the
+            // policy.
+            return syscall(SYS_mbind, begin, end - begin, mode, mask, max_node, MpolMfMove) == 0;
+#else
+            (void)data, (void)bytes, (void)policy;
+            return false;
+#endif
+        }
+
+        int node_of(const void *address)
+        {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+            int node = -1;
+            if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, MpolFNode | MpolFAddr) != 0)
+                return -1;
+            return node;
+#else
+            (void)address;
+            return -1;
+#endif
+        }
+
+        bool pin_current_thread(const std::vector<int> &cpus)
+        {
+#ifdef __linux__
+            if (cpus.empty())
+                return false;
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus)
+                if (cpu >= 0 && cpu < CPU_SETSIZE)
+                    CPU_SET(cpu, &set);
+            return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+            (void)cpus;
+            return false;
+#endif
+        }
+
+        size_t pin_omp_threads(Affinity affinity)
+        {
+            std::vector<std::vector<int>> groups;
+            for (size_t node = 0; node < nodes(); node++)
+                if (auto group = cpus((int)node); !group.empty())
+                    groups.push_back(group);
+
+            std::vector<int> order;
+            size_t widest = 0;
+            for (auto &group : groups)
+                widest = std::max(widest, group.size());
+
+            if (affinity == Affinity::Compact)
+            {
+                for (auto &group : groups)
+                    order.insert(order.end(), group.begin(), group.end());
+            }
+            else
+            {
+                for (size_t i = 0; i < widest; i++)
+                    for (auto &group : groups)
+                        if (i < group.size())
+                            order.push_back(group[i]);
+            }
+
+            if (order.empty())
+                return 0;
+
+            size_t pinned = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+ : pinned)
+            pinned += pin_current_thread({order[omp_get_thread_num() % order.size()]});
+#else
+            pinned += pin_current_thread({order[0]});
+#endif
+            return pinned;
+        }
+    }
+}
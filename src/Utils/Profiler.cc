@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include "Utils/Profiler.h"
+
+namespace StaticNet
+{
+    namespace Profiler
+    {
+        namespace
+        {
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<std::string> names;
+                std::vector<ThreadState *> threads;
+                std::vector<Counters> retired;
+                std::vector<std::pair<size_t, TraceEvent>> retired_events;
+                size_t next_tid = 0;
+            };
+
+            Registry &registry()
+            {
+                static Registry instance;
+                return instance;
+            }
+
+            double ticks_per_second()
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                static const double rate = []() {
+                    auto begin = std::chrono::steady_clock::now();
+                    uint64_t begin_ticks = ticks();
+                    while (std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(20))
+                        ;
+                    uint64_t end_ticks = ticks();
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                    return (end_ticks - begin_ticks) / seconds;
+                }();
+                return rate;
+#else
+                return 1e9;
+#endif
+            }
+
+            void escape(std::ostream &os, const std::string &text)
+            {
+                for (char c : text)
+                {
+                    if (c == '"' || c == '\\')
+                        os << '\\';
+                    os << c;
+                }
+            }
+        }
+
+        Counters &Counters::operator+=(const Counters &other)
+        {
+            calls += other.calls;
+            ticks += other.ticks;
+            flops += other.flops;
+            bytes += other.bytes;
+            allocations += other.allocations;
+            allocated_bytes += other.allocated_bytes;
+            return *this;
+        }
+
+        void SharedCounters::add(const Counters &counters)
+        {
+            calls.fetch_add(counters.calls, std::memory_order_relaxed);
+            ticks.fetch_add(counters.ticks, std::memory_order_relaxed);
+            flops.fetch_add(counters.flops, std::memory_order_relaxed);
+            bytes.fetch_add(counters.bytes, std::memory_order_relaxed);
+            allocations.fetch_add(counters.allocations, std::memory_order_relaxed);
+            allocated_bytes.fetch_add(counters.allocated_bytes, std::memory_order_relaxed);
+        }
+
+        Counters SharedCounters::load() const
+        {
+            Counters counters;
+            counters.calls = calls.load(std::memory_order_relaxed);
+            counters.ticks = ticks.load(std::memory_order_relaxed);
+            counters.flops = flops.load(std::memory_order_relaxed);
+            counters.bytes = bytes.load(std::memory_order_relaxed);
+            counters.allocations = allocations.load(std::memory_order_relaxed);
+            counters.allocated_bytes = allocated_bytes.load(std::memory_order_relaxed);
+            return counters;
+        }
+
+        void SharedCounters::reset()
+        {
+            calls = 0;
+            ticks = 0;
+            flops = 0;
+            bytes = 0;
+            allocations = 0;
+            allocated_bytes = 0;
+        }
+
+        ThreadState::ThreadState()
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            tid = reg.next_tid++;
+            reg.threads.push_back(this);
+        }
+
+        ThreadState::~ThreadState()
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (reg.retired.size() < kernels.size())
+                reg.retired.resize(kernels.size());
+            for (size_t i = 0; i < kernels.size(); i++)
+                reg.retired[i] += kernels[i];
+            for (auto &event : events)
+                reg.retired_events.emplace_back(tid, std::move(event));
+            reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), this));
+        }
+
+        void enable(bool trace)
+        {
+            ticks_per_second();
+            tracing = trace;
+            active = true;
+        }
+
+        void disable()
+        {
+            active = false;
+            tracing = false;
+        }
+
+        void reset()
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.retired.clear();
+            reg.retired_events.clear();
+            for (ThreadState *state : reg.threads)
+            {
+                state->kernels.clear();
+                state->events.clear();
+            }
+        }
+
+        double ticks_to_seconds(uint64_t ticks)
+        {
+            return ticks / ticks_per_second();
+        }
+
+        size_t register_kernel(const char *name)
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            auto it = std::find(reg.names.begin(), reg.names.end(), name);
+            if (it != reg.names.end())
+                return it - reg.names.begin();
+
+            reg.names.push_back(name);
+            return reg.names.size() - 1;
+        }
+
+        std::vector<std::pair<std::string, Counters>> kernels()
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+
+            std::vector<Counters> totals = reg.retired;
+            totals.resize(reg.names.size());
+            for (ThreadState *state : reg.threads)
+                for (size_t i = 0; i < state->kernels.size(); i++)
+                    totals[i] += state->kernels[i];
+
+            std::vector<std::pair<std::string, Counters>> result;
+            for (size_t i = 0; i < reg.names.size(); i++)
+                if (totals[i].calls)
+                    result.emplace_back(reg.names[i], totals[i]);
+            return result;
+        }
+
+        std::string format(const Counters &counters)
+        {
+            double seconds = ticks_to_seconds(counters.ticks);
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(3)
+               << counters.calls << " calls, "
+               << seconds * 1e3 << " ms, "
+               << counters.flops * 1e-9 << " GFLOP (" << (seconds > 0 ? counters.flops / seconds * 1e-9 : 0.0) << " GFLOP/s), "
+               << counters.bytes / 1048576.0 << " MiB, "
+               << counters.allocations << " allocs";
+            return os.str();
+        }
+
+        void print_kernels(std::ostream &os)
+        {
+            for (const auto &[name, counters] : kernels())
+                os << name << ": " << format(counters) << "\n";
+        }
+
+        void write_chrome_trace(std::ostream &os)
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+
+            std::vector<std::pair<size_t, const TraceEvent *>> events;
+            for (const auto &[tid, event] : reg.retired_events)
+                events.emplace_back(tid, &event);
+            for (ThreadState *state : reg.threads)
+                for (const auto &event : state->events)
+                    events.emplace_back(state->tid, &event);
+
+            uint64_t origin = UINT64_MAX;
+            for (const auto &[tid, event] : events)
+                origin = std::min(origin, event->begin);
+
+            double us_per_tick = 1e6 / ticks_per_second();
+            os << "{\"traceEvents\": [";
+            for (size_t i = 0; i < events.size(); i++)
+            {
+                const TraceEvent &event = *events[i].second;
+                os << (i ? ",\n" : "\n") << "{\"name\": \"";
+                escape(os, event.name);
+                os << "\", \"cat\": \"" << event.category << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << events[i].first
+                   << std::fixed << std::setprecision(3)
+                   << ", \"ts\": " << (event.begin - origin) * us_per_tick
+                   << ", \"dur\": " << (event.end - event.begin) * us_per_tick << "}";
+            }
+            os << "\n]}\n";
+        }
+
+        bool write_chrome_trace(const std::string &path)
+        {
+            std::ofstream file(path);
+            if (!file.is_open())
+                return false;
+
+            write_chrome_trace(file);
+            return true;
+        }
+    }
+}
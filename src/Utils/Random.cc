@@ -4,23 +4,42 @@ namespace StaticNet
 {
     namespace Random
     {
-        static std::uniform_real_distribution<float> float_dist(-0.25f, 0.25f);
-        static std::uniform_real_distribution<double> double_dist(0.0, 1.0);
-        static std::bernoulli_distribution bool_dist(0.5);
-        
+        namespace
+        {
+            // Root of the per-thread scalar streams; its children have the
+            // top bit set, so they never meet a next_stream() id.
+            constexpr uint64_t ScalarStreams = 0;
+
+            Generator &thread_generator()
+            {
+                thread_local uint64_t seen_epoch = ~0ull, seen_key = ~0ull;
+                thread_local Generator generator(ScalarStreams);
+                const uint64_t current = epoch.load(std::memory_order_relaxed), index = thread_index();
+                if (seen_epoch != current || (index != UnsetThreadIndex && seen_key != index))
+                {
+                    seen_epoch = current;
+                    seen_key = index != UnsetThreadIndex
+                                   ? index
+                                   : ImplicitThreadKeys | implicit_keys.fetch_add(1, std::memory_order_relaxed);
+                    generator = Generator(ScalarStreams, global_seed).split(seen_key);
+                }
+                return generator;
+            }
+        }
+
         template <>
         float rand() {
-            return float_dist(mt);
+            return thread_generator().uniform(-0.25f, 0.25f);
         }
 
         template <>
         double rand() {
-            return double_dist(mt);
+            return thread_generator().uniform(0.0, 1.0);
         }
 
         template <>
         bool rand() {
-            return bool_dist(mt);
+            return thread_generator().bernoulli(0.5);
         }
     }
-}
\ No newline at end of file
+}
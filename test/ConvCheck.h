@@ -0,0 +1,45 @@
+#ifndef CONV_CHECK_H_
+#define CONV_CHECK_H_
+
+#include <cassert>
+#include <cmath>
+
+#include "Tensor.h"
+
+// Checks shared by the convolution tests.
+
+template <size_t Size>
+float inner(const float *a, const float *b)
+{
+    double sum = 0;
+    for (size_t i = 0; i < Size; i++)
+        sum += (double)a[i] * b[i];
+    return (float)sum;
+}
+
+// <out, y> == <x, dx> up to float rounding.
+template <size_t OutputSize, size_t InputSize>
+bool adjoint(const float *out, const float *y, const float *x, const float *dx)
+{
+    const float lhs = inner<OutputSize>(out, y), rhs = inner<InputSize>(x, dx);
+    return std::fabs(lhs - rhs) < 1e-3f * (1 + std::fabs(lhs));
+}
+
+// The backward pass must be the adjoint of the forward's linear part:
+// <conv(x) - conv(0), y> == <x, dconv(y)>. Input and Output are the batched
+// tensors in the module's layout.
+template <class Input, class Output, class Conv>
+void check_adjoint(Conv &conv)
+{
+    auto x = Input::random();
+    auto y = Output::random();
+
+    auto bias = conv.forward(Input());
+    auto out = conv.forward(x);
+    out -= bias;
+    auto dx = conv.backward(y, 0.0f);
+
+    assert((adjoint<Output::Size, Input::Size>(out.data, y.data, x.data, dx.data)));
+}
+
+#endif
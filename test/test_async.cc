@@ -0,0 +1,181 @@
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+#include "Defines.h"
+#include "Modules/Checkpoint.h"
+#include "Modules/Conv2D.h"
+#include "Modules/Linear.h"
+#include "Modules/ReLU.h"
+#include "Utils/Async.h"
+
+using namespace StaticNet;
+
+constexpr size_t Batch = 4;
+constexpr size_t Steps = 5;
+
+class Net : public Module<float>
+{
+public:
+    Net() : Module<float>("Net"), conv(this), relu(this), fc(this) {}
+
+    Tensor<float, Batch, 3> forward(const Tensor<float, Batch, 2, 6, 6> &input)
+    {
+        auto features = relu.forward(conv.forward(input));
+        return fc.forward(features.template reshape<Batch, 4 * 4 * 4>());
+    }
+
+    void backward(const Tensor<float, Batch, 3> &delta, float learningRate)
+    {
+        auto dfeatures = fc.backward(delta, learningRate);
+        conv.backward(relu.backward(dfeatures.template reshape<Batch, 4, 4, 4>(), learningRate), learningRate);
+    }
+
+    Conv2D<Tensor<float, 2, 6, 6>, Tensor<float, 4, 4, 4>> conv;
+    ReLU<Tensor<float, 4, 4, 4>> relu;
+    Linear<Tensor<float, 4 * 4 * 4>, Tensor<float, 3>> fc;
+};
+
+class Dense : public Module<float>
+{
+public:
+    Dense(Module<float> *parent) : Module<float>("Dense", parent), fc(this) {}
+
+    template <size_t B>
+    static constexpr ModuleCost cost()
+    {
+        return decltype(fc)::cost<B>();
+    }
+
+    template <size_t B>
+    Tensor<float, B, 512> forward(const Tensor<float, B, 512> &input)
+    {
+        return fc.forward(input);
+    }
+
+    template <size_t B>
+    Tensor<float, B, 512> backward(const Tensor<float, B, 512> &delta, float learningRate)
+    {
+        return fc.backward(delta, learningRate);
+    }
+
+private:
+    Linear<Tensor<float, 512>, Tensor<float, 512>> fc;
+};
+
+Task<int> square(int x)
+{
+    co_await thread_pool().schedule();
+    co_return x * x;
+}
+
+// Awaits two tasks from inside a coroutine, without blocking a worker.
+Task<int> sum_of_squares(int a, int b)
+{
+    auto first = square(a);
+    auto second = square(b);
+    co_return co_await first + co_await second;
+}
+
+void test_tasks()
+{
+    const int answer = async([]() { return 6 * 7; }).get();
+    assert(answer == 42);
+    const int sum = sum_of_squares(3, 4).get();
+    assert(sum == 25);
+
+    int counter = 0;
+    {
+        auto task = async([&counter]() { counter = 1; });
+        task.wait();
+        assert(task.done() && task.valid());
+    }
+    assert(counter == 1);
+
+    // The destructor waits for a task still in flight.
+    {
+        auto task = async([&counter]() { counter = 2; });
+    }
+    assert(counter == 2);
+
+    auto tensor = async([]() { return Tensor<float, 3>{1.0f, 2.0f, 3.0f}; }).get();
+    assert(tensor[2] == 3.0f);
+
+    auto failing = async([]() -> int { throw std::runtime_error("step failed"); });
+    bool thrown = false;
+    try
+    {
+        failing.get();
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown && !failing.valid());
+}
+
+Tensor<float, Batch, 3> train(bool overlap)
+{
+    Random::seed(7);
+    Net net;
+    auto input = Tensor<float, Batch, 2, 6, 6>::random();
+    auto delta = Tensor<float, Batch, 3>::random();
+    net.overlap(overlap);
+
+    for (size_t i = 0; i < Steps; i++)
+    {
+        net.forward(input);
+        net.backward(delta, 0.05f);
+    }
+    net.synchronize();
+    return net.forward(input);
+}
+
+// The overlapped steps see the same gradients as the synchronous ones;
+// only Linear's unfused update rounds differently.
+void test_overlap()
+{
+    auto serial = train(false);
+    auto overlapped = train(true);
+    for (size_t b = 0; b < Batch; b++)
+        for (size_t o = 0; o < 3; o++)
+            assert(std::abs(serial[b][o] - overlapped[b][o]) <= 1e-4f * (1.0f + std::abs(serial[b][o])));
+}
+
+// Checkpoint frees the segment's saved input right after its backward,
+// while the overlapped Linear step still reads it.
+Tensor<float, 64, 512> train_checkpointed(bool overlap)
+{
+    Random::seed(11);
+    Module<float> root("Root");
+    Checkpoint<Tensor<float, 512>, Dense> block(&root);
+    auto input = Tensor<float, 64, 512>::random();
+    auto delta = Tensor<float, 64, 512>::random();
+    root.overlap(overlap);
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        block.forward(input);
+        block.backward(delta, 0.01f);
+        assert(root.memory_bytes() == 0);
+    }
+    root.synchronize();
+    return block.forward(input);
+}
+
+void test_checkpoint_overlap()
+{
+    auto serial = train_checkpointed(false);
+    auto overlapped = train_checkpointed(true);
+    for (size_t i = 0; i < 64 * 512; i++)
+        assert(std::abs(serial.data[i] - overlapped.data[i]) <= 1e-4f * (1.0f + std::abs(serial.data[i])));
+}
+
+int main()
+{
+    assert(thread_pool().size() >= 1);
+    test_tasks();
+    test_overlap();
+    test_checkpoint_overlap();
+    return 0;
+}
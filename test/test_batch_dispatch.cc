@@ -0,0 +1,64 @@
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "Models/AffineNet.h"
+#include "Utils/BatchDispatch.h"
+
+using namespace StaticNet;
+
+using Dispatch = BatchDispatch<AffineNet, Tensor<float, 784>, Tensor<float, 10>, 1, 8, 32>;
+
+void test_plan()
+{
+    using Sparse = BatchDispatch<AffineNet, Tensor<float, 784>, Tensor<float, 10>, 3, 5>;
+
+    assert(Dispatch::plan(0).empty());
+    assert(Dispatch::plan(8) == std::vector<size_t>({8}));
+    assert(Dispatch::plan(45) == std::vector<size_t>({32, 8, 1, 1, 1, 1, 1}));
+    assert(Dispatch::plan(100) == std::vector<size_t>({32, 32, 32, 1, 1, 1, 1}));
+
+    // Without a batch of 1 only the last chunk is padded, and only when
+    // no exact split exists.
+    assert(Sparse::plan(1) == std::vector<size_t>({3}));
+    assert(Sparse::plan(6) == std::vector<size_t>({3, 3}));
+    assert(Sparse::plan(7) == std::vector<size_t>({5, 3}));
+    assert(Sparse::plan(11) == std::vector<size_t>({5, 3, 3}));
+    assert(Sparse::plan(27) == std::vector<size_t>({5, 5, 5, 3, 3, 3, 3}));
+    assert(Sparse::plan(52) == std::vector<size_t>({5, 5, 5, 5, 5, 5, 5, 5, 3, 3, 3, 3}));
+}
+
+void test_forward()
+{
+    AffineNet model;
+    Dispatch dispatch(model);
+
+    constexpr size_t Count = 45;
+    auto samples = Tensor<float, 64, 784>::random();
+    auto rows = dispatch.forward(samples, Count);
+    assert(rows.size() == Count && rows.segments().size() == 7);
+
+    for (size_t i = 0; i < Count; i++)
+    {
+        Tensor<float, 1, 784> single;
+        single[0] = samples[i];
+        auto expected = model.forward<1>(single);
+        for (size_t j = 0; j < 10; j++)
+            assert(std::fabs(expected[0][j] - rows[i][j]) < 1e-4f);
+    }
+
+    auto stats = dispatch.stats();
+    assert(stats.requests == Count && stats.batches == 7 && stats.padded_rows == 0);
+
+    // The rows stay valid across later calls.
+    const float first = rows[0][0];
+    dispatch.forward(samples, 3);
+    assert(rows[0][0] == first);
+}
+
+int main()
+{
+    test_plan();
+    test_forward();
+    return 0;
+}
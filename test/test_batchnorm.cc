@@ -0,0 +1,188 @@
+#include <cassert>
+#include <cmath>
+
+#include "Modules/BatchNorm.h"
+#include "Modules/Checkpoint.h"
+#include "Modules/Conv2D.h"
+#include "Modules/Linear.h"
+
+using namespace StaticNet;
+
+template <size_t Size, class T>
+double inner(const T *a, const T *b)
+{
+    double sum = 0;
+    for (size_t i = 0; i < Size; i++)
+        sum += (double)a[i] * b[i];
+    return sum;
+}
+
+// Per-channel mean / variance of an NCHW batch, in doubles.
+template <size_t Batch, size_t C, size_t P, class T>
+void naive_statistics(const T *x, double *mean, double *var)
+{
+    for (size_t c = 0; c < C; c++)
+    {
+        double sum = 0, sq = 0;
+        for (size_t b = 0; b < Batch; b++)
+            for (size_t p = 0; p < P; p++)
+                sum += x[(b * C + c) * P + p];
+        mean[c] = sum / (Batch * P);
+        for (size_t b = 0; b < Batch; b++)
+            for (size_t p = 0; p < P; p++)
+                sq += (x[(b * C + c) * P + p] - mean[c]) * (x[(b * C + c) * P + p] - mean[c]);
+        var[c] = sq / (Batch * P);
+    }
+}
+
+// backward must match central differences of <forward(x), g>.
+template <size_t Batch, size_t... D, class Norm>
+void check_gradient(Norm &norm)
+{
+    constexpr size_t Size = Batch * (... * D);
+    auto x = Tensor<double, Batch, D...>::random();
+    auto g = Tensor<double, Batch, D...>::random();
+
+    norm.forward(x);
+    auto dx = norm.backward(g, 0.0f);
+
+    for (size_t i = 0; i < Size; i += Size / 7 + 1)
+    {
+        const double h = 1e-5, saved = x.data[i];
+        x.data[i] = saved + h;
+        auto up = norm.forward(x);
+        x.data[i] = saved - h;
+        auto down = norm.forward(x);
+        x.data[i] = saved;
+
+        const double numeric = (inner<Size>(up.data, g.data) - inner<Size>(down.data, g.data)) / (2 * h);
+        assert(std::fabs(numeric - dx.data[i]) < 1e-6 * (1 + std::fabs(numeric)));
+    }
+}
+
+int main()
+{
+    Module<float> root("Root");
+    Module<double> droot("Root");
+
+    // Training forward normalizes every channel; a shifted, scaled input
+    // exercises the numerics of the single-pass statistics.
+    {
+        constexpr size_t Batch = 8, C = 16, H = 16, W = 16;
+        BatchNorm2D<Tensor<float, C, H, W>> norm(&root);
+        auto x = Tensor<float, Batch, C, H, W>::random();
+        for (size_t i = 0; i < Batch * C * H * W; i++)
+            x.data[i] = 1000.0f + 40.0f * x.data[i];
+
+        double mean[C], var[C];
+        naive_statistics<Batch, C, H * W>(x.data, mean, var);
+
+        auto y = norm.forward(x);
+        double out_mean[C], out_var[C];
+        naive_statistics<Batch, C, H * W>(y.data, out_mean, out_var);
+        for (size_t c = 0; c < C; c++)
+        {
+            assert(std::fabs(out_mean[c]) < 1e-3);
+            assert(std::fabs(out_var[c] - var[c] / (var[c] + 1e-5)) < 1e-3);
+            assert(std::fabs(norm.running_mean[c] - 0.1 * mean[c]) < 1e-2);
+        }
+
+        // Channel-last and blocked layouts give the same result.
+        BatchNorm2D<Tensor<float, C, H, W>, NHWC> last(&root);
+        BatchNorm2D<Tensor<float, C, H, W>, NChw8c> blocked(&root);
+        auto y_last = reorder<NHWC, NCHW, C, H, W>(last.forward(reorder<NCHW, NHWC, C, H, W>(x)));
+        auto y_blocked = reorder<NChw8c, NCHW, C, H, W>(blocked.forward(reorder<NCHW, NChw8c, C, H, W>(x)));
+        for (size_t i = 0; i < Batch * C * H * W; i++)
+        {
+            assert(std::fabs(y_last.data[i] - y.data[i]) < 1e-4f);
+            assert(std::fabs(y_blocked.data[i] - y.data[i]) < 1e-4f);
+        }
+    }
+
+    // Gradients with batch statistics, planar, channel-last and flat.
+    {
+        BatchNorm2D<Tensor<double, 3, 4, 5>> planar(&droot);
+        check_gradient<2, 3, 4, 5>(planar);
+
+        BatchNorm2D<Tensor<double, 20, 2, 3>, NHWC> last(&droot);
+        check_gradient<3, 2, 3, 20>(last);
+
+        BatchNorm1D<Tensor<double, 7>> flat(&droot);
+        check_gradient<5, 7>(flat);
+    }
+
+    // Folding into the preceding layer leaves the inference output unchanged.
+    {
+        Conv2D<Tensor<float, 2, 8, 8>, Tensor<float, 6, 6, 6>, Window2D<3>, NHWC> conv(&root);
+        BatchNorm2D<Tensor<float, 6, 6, 6>, NHWC> norm(&root);
+        for (int step = 0; step < 5; step++)
+            norm.forward(conv.forward(Tensor<float, 4, 8, 8, 2>::random()));
+
+        norm.train(false);
+        auto x = Tensor<float, 4, 8, 8, 2>::random();
+        auto expected = norm.forward(conv.forward(x));
+        norm.fold_into(conv);
+        auto folded = norm.forward(conv.forward(x));
+        for (size_t i = 0; i < 4 * 6 * 6 * 6; i++)
+            assert(std::fabs(folded.data[i] - expected.data[i]) < 1e-4f * (1 + std::fabs(expected.data[i])));
+    }
+    {
+        Module<float> model("Model");
+        Linear<Tensor<float, 12>, Tensor<float, 5>> linear(&model);
+        BatchNorm1D<Tensor<float, 5>> norm(&model);
+        for (int step = 0; step < 5; step++)
+            norm.forward(linear.forward(Tensor<float, 16, 12>::random()));
+
+        model.train(false);
+        auto x = Tensor<float, 3, 12>::random();
+        auto expected = norm.forward(linear.forward(x));
+        norm.fold_into(linear);
+        auto folded = norm.forward(linear.forward(x));
+        for (size_t i = 0; i < 3 * 5; i++)
+            assert(std::fabs(folded.data[i] - expected.data[i]) < 1e-4f * (1 + std::fabs(expected.data[i])));
+
+        // Training again normalizes with batch statistics and updates beta.
+        model.train(true);
+        auto batch = Tensor<float, 16, 12>::random();
+        auto y = norm.forward(linear.forward(batch));
+        for (size_t c = 0; c < 5; c++)
+        {
+            float mean = 0.0f;
+            for (size_t b = 0; b < 16; b++)
+                mean += y[b][c] / 16;
+            assert(std::fabs(mean) < 1e-4f);
+        }
+        // A constant gradient moves only beta: by rate * mean(dy) = 0.1.
+        Tensor<float, 16, 5> delta(1.0f);
+        norm.backward(delta, 0.1f);
+        auto shifted = norm.forward(linear.forward(batch));
+        for (size_t i = 0; i < 16 * 5; i++)
+            assert(std::fabs(shifted.data[i] - (y.data[i] - 0.1f)) < 1e-4f);
+    }
+
+    // Recomputing the pass inside a Checkpoint leaves the running statistics
+    // as one plain training step per batch would.
+    {
+        Module<float> model("Model");
+        BatchNorm1D<Tensor<float, 5>> plain(&model);
+        Checkpoint<Tensor<float, 5>, BatchNorm1D<Tensor<float, 5>>> checkpointed(&model);
+        for (int step = 0; step < 3; step++)
+        {
+            auto x = Tensor<float, 16, 5>::random();
+            auto g = Tensor<float, 16, 5>::random();
+            plain.forward(x);
+            plain.backward(g, 0.1f);
+            checkpointed.forward(x);
+            checkpointed.backward(g, 0.1f);
+        }
+        for (size_t c = 0; c < 5; c++)
+        {
+            assert(std::fabs(checkpointed.segment.running_mean[c] - plain.running_mean[c]) < 1e-6f);
+            assert(std::fabs(checkpointed.segment.running_var[c] - plain.running_var[c]) < 1e-6f);
+        }
+    }
+
+    static_assert(BatchNorm1D<Tensor<float, 5>>::cost<1>().parameters == 10);
+
+    return 0;
+}
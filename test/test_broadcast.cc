@@ -0,0 +1,122 @@
+#include <cassert>
+#include <cmath>
+
+#include "Tensor.h"
+
+using namespace StaticNet;
+
+int main()
+{
+    // Per-channel bias over [batch, C, H, W].
+    {
+        Tensor<float, 2, 3, 4, 5> x = Tensor<float, 2, 3, 4, 5>::random();
+        Tensor<float, 3, 1, 1> bias = Tensor<float, 3, 1, 1>::random();
+
+        Tensor<float, 2, 3, 4, 5> y = x + bias;
+        for (size_t b = 0; b < 2; b++)
+            for (size_t c = 0; c < 3; c++)
+                for (size_t h = 0; h < 4; h++)
+                    for (size_t w = 0; w < 5; w++)
+                        assert(y[b][c][h][w] == x[b][c][h][w] + bias[c][0][0]);
+
+        x += bias;
+        assert(x == y);
+    }
+
+    // Row plus column: [4, 1] + [3] -> [4, 3], and the mirrored order.
+    {
+        Tensor<int, 4, 1> column;
+        Tensor<int, 3> row;
+        for (int i = 0; i < 4; i++)
+            column[i][0] = 10 * i;
+        for (int j = 0; j < 3; j++)
+            row[j] = j;
+
+        Tensor<int, 4, 3> sum = column + row;
+        Tensor<int, 4, 3> difference = row - column;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 3; j++)
+            {
+                assert(sum[i][j] == 10 * i + j);
+                assert(difference[i][j] == j - 10 * i);
+            }
+    }
+
+    // Same shapes and bias rows take the merged fast paths, across threads.
+    {
+        Tensor<float, 512, 96> a = Tensor<float, 512, 96>::random();
+        Tensor<float, 512, 96> b = Tensor<float, 512, 96>::random();
+        Tensor<float, 96> bias = Tensor<float, 96>::random();
+
+        Tensor<float, 512, 96> product = a * b;
+        Tensor<float, 512, 96> shifted = a - bias;
+        for (size_t i = 0; i < 512; i++)
+            for (size_t j = 0; j < 96; j++)
+            {
+                assert(product[i][j] == a[i][j] * b[i][j]);
+                assert(shifted[i][j] == a[i][j] - bias[j]);
+            }
+    }
+
+    // Per-channel scaling in place, then dividing it back out.
+    {
+        Tensor<double, 2, 3, 8> x = Tensor<double, 2, 3, 8>::random();
+        const Tensor<double, 2, 3, 8> &view = x;
+        Tensor<double, 2, 3, 8> original(view);
+        Tensor<double, 3, 1> scale(2.0);
+        scale[1][0] = 4.0;
+
+        x *= scale;
+        for (size_t b = 0; b < 2; b++)
+            for (size_t c = 0; c < 3; c++)
+                for (size_t i = 0; i < 8; i++)
+                    assert(x[b][c][i] == original[b][c][i] * scale[c][0]);
+
+        x /= scale;
+        for (size_t b = 0; b < 2; b++)
+            for (size_t c = 0; c < 3; c++)
+                for (size_t i = 0; i < 8; i++)
+                    assert(std::fabs(x[b][c][i] - original[b][c][i]) < 1e-12);
+    }
+
+    // Slices on either side; a strided destination is written back.
+    {
+        Tensor<int, 3, 4, 2> x;
+        Tensor<int, 4, 1> offset;
+        for (int i = 0; i < 4; i++)
+            offset[i][0] = i + 1;
+
+        x[1] += offset;
+        for (size_t i = 0; i < 3; i++)
+            for (size_t j = 0; j < 4; j++)
+                for (size_t k = 0; k < 2; k++)
+                    assert(x[i][j][k] == (i == 1 ? (int)j + 1 : 0));
+
+        Tensor<int, 4, 2> doubled = x[1] + x[1];
+        for (size_t j = 0; j < 4; j++)
+            for (size_t k = 0; k < 2; k++)
+                assert(doubled[j][k] == 2 * ((int)j + 1));
+    }
+
+    // Scalars still take the scalar overloads.
+    {
+        Tensor<float, 4> x(1.0f);
+        x *= 3;
+        Tensor<float, 4> y = x / 2.0f;
+        assert(y[3] == 1.5f);
+    }
+
+    // Broadcasting a scalar-shaped tensor.
+    {
+        Tensor<float, 2, 3> x(1.0f);
+        Tensor<float, 1> two(2.0f);
+        Tensor<float, 2, 3> y = x + two;
+        assert(y[1][2] == 3.0f);
+    }
+
+    static_assert(TensorUtils::broadcast_tensor<Tensor<float, 2, 3>, Tensor<float, 4, 1, 3>>::valid);
+    static_assert(!TensorUtils::broadcast_tensor<Tensor<float, 2, 3>, Tensor<float, 3, 3>>::valid);
+    static_assert(std::is_same_v<TensorUtils::broadcast_t<float, Tensor<float, 2, 1, 5>, Tensor<float, 7, 1>>, Tensor<float, 2, 7, 5>>);
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <cassert>
+
+#include "Modules/Checkpoint.h"
+#include "Modules/Conv2D.h"
+#include "Modules/Linear.h"
+#include "Modules/ReLU.h"
+
+using namespace StaticNet;
+
+class Block : public Module<float>
+{
+public:
+    Block(Module<float> *parent) : Module<float>("Block", parent), conv(this), relu(this) {}
+
+    template <size_t Batch>
+    static constexpr ModuleCost cost()
+    {
+        return decltype(conv)::cost<Batch>() + decltype(relu)::cost<Batch>();
+    }
+
+    template <size_t Batch>
+    Tensor<float, Batch, 4, 8, 8> forward(const Tensor<float, Batch, 1, 12, 12> &input)
+    {
+        return relu.forward(conv.forward(input));
+    }
+
+    template <size_t Batch>
+    Tensor<float, Batch, 1, 12, 12> backward(const Tensor<float, Batch, 4, 8, 8> &delta, float learningRate)
+    {
+        return conv.backward(relu.backward(delta, learningRate), learningRate);
+    }
+
+private:
+    Conv2D<Tensor<float, 1, 12, 12>, Tensor<float, 4, 8, 8>, Window2D<5>> conv;
+    ReLU<Tensor<float, 4, 8, 8>> relu;
+};
+
+constexpr size_t Batch = 6;
+constexpr size_t InputBytes = Batch * 144 * sizeof(float);
+
+static_assert(Checkpoint<Tensor<float, 1, 12, 12>, Block>::cost<Batch>().cached_bytes == InputBytes);
+static_assert(Checkpoint<Tensor<float, 1, 12, 12>, Block>::cost<Batch>().backward_flops ==
+              Block::cost<Batch>().backward_flops + Block::cost<Batch>().forward_flops);
+static_assert(Checkpoint<Tensor<float, 1, 12, 12>, Block>::cost<Batch>().parameters == Block::cost<Batch>().parameters);
+
+int main()
+{
+    Module<float> root("Root");
+    Checkpoint<Tensor<float, 1, 12, 12>, Block> block(&root);
+    Linear<Tensor<float, 16>, Tensor<float, 16>> first(&root), second(&root);
+    assert(block.parameters == Block::cost<1>().parameters);
+    assert(root.parameters == block.parameters + first.parameters + second.parameters);
+
+    auto x = Tensor<float, Batch, 1, 12, 12>::random();
+    auto dy = Tensor<float, Batch, 4, 8, 8>::random();
+
+    // Plain pass: the segment keeps its im2col buffer and ReLU input.
+    root.checkpoint(false);
+    auto y_plain = block.forward(x);
+    const size_t plain_bytes = root.memory_bytes();
+    assert(plain_bytes > InputBytes);
+    auto dx_plain = block.backward(dy, 0.0f);
+
+    // Checkpointed pass: only the segment input stays alive, and everything
+    // is freed once backward has recomputed and consumed the activations.
+    block.release();
+    root.checkpoint(true);
+    auto y = block.forward(x);
+    assert(root.memory_bytes() == InputBytes);
+    auto dx = block.backward(dy, 0.0f);
+    assert(root.memory_bytes() == 0);
+
+    for (size_t i = 0; i < Batch * 4 * 8 * 8; i++)
+        assert(y.data[i] == y_plain.data[i]);
+    for (size_t i = 0; i < Batch * 144; i++)
+        assert(dx.data[i] == dx_plain.data[i]);
+
+    // A training step still moves the weights.
+    block.forward(x);
+    block.backward(dy, 0.1f);
+    auto y_next = block.forward(x);
+    bool changed = false;
+    for (size_t i = 0; i < Batch * 4 * 8 * 8; i++)
+        changed |= y_next.data[i] != y.data[i];
+    assert(changed);
+
+    // Memory is per instance: equal shapes no longer share one buffer.
+    auto a = Tensor<float, Batch, 16>::random();
+    auto b = Tensor<float, Batch, 16>::random();
+    first.forward(a);
+    second.forward(b);
+    const auto &saved_a = first.memory<Batch, 16>(AccessType::Read);
+    const auto &saved_b = second.memory<Batch, 16>(AccessType::Read);
+    for (size_t i = 0; i < Batch * 16; i++)
+        assert(saved_a.data[i] == a.data[i] && saved_b.data[i] == b.data[i]);
+
+    return 0;
+}
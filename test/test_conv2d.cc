@@ -0,0 +1,45 @@
+#include <cassert>
+#include <cmath>
+
+#include "Modules/Conv2D.h"
+#include "ConvCheck.h"
+
+using namespace StaticNet;
+
+int main()
+{
+    Module<float> root("Root");
+
+    // 3x3, stride 2, "same" padding on a non-square input.
+    using Strided = Window2D<3, 3, 2, 2, 1, 1>;
+    Conv2D<Tensor<float, 2, 9, 8>, Tensor<float, 3, 5, 4>, Strided> strided(&root);
+    check_adjoint<Tensor<float, 2, 2, 9, 8>, Tensor<float, 2, 3, 5, 4>>(strided);
+
+    // Shifting the input by one stride shifts the output by one pixel.
+    auto x = Tensor<float, 1, 2, 9, 8>::random();
+    Tensor<float, 1, 2, 9, 8> shifted;
+    for (size_t c = 0; c < 2; c++)
+        for (size_t i = 0; i < 9; i++)
+            for (size_t j = 2; j < 8; j++)
+                shifted[0][c][i][j] = x[0][c][i][j - 2];
+
+    auto out = strided.forward(x);
+    auto out_shifted = strided.forward(shifted);
+    for (size_t f = 0; f < 3; f++)
+        for (size_t i = 0; i < 5; i++)
+            for (size_t j = 0; j + 1 < 4; j++)
+                assert(std::fabs(out[0][f][i][j] - out_shifted[0][f][i][j + 1]) < 1e-4f);
+
+    // Dilated 2x2 taps spanning 3x3, plus the stride-1 shorthand.
+    Conv2D<Tensor<float, 3, 7, 6>, Tensor<float, 2, 5, 4>, Window2D<2, 2, 1, 1, 0, 0, 2, 2>> dilated(&root);
+    check_adjoint<Tensor<float, 3, 3, 7, 6>, Tensor<float, 3, 2, 5, 4>>(dilated);
+
+    Conv2D<Tensor<float, 1, 6, 5>, Tensor<float, 2, 4, 2>> plain(&root);
+    check_adjoint<Tensor<float, 2, 1, 6, 5>, Tensor<float, 2, 2, 4, 2>>(plain);
+    static_assert(decltype(plain)::cost<1>().parameters == 2 * 1 * 3 * 4 + 2);
+
+    // pad2d over channels pads every plane.
+    Tensor<int, 2, 2, 2> planes = {{{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}};
+    Tensor<int, 2, 4, 4> padded = pad2d<1>(planes, -1);
+    assert(padded[1][0][0] == -1 && padded[1][3][3] == -1 && padded[1][1][1] == 5 && padded[0][2][2] == 4);
+}
@@ -0,0 +1,36 @@
+#include <cassert>
+
+#include "Models/LeNet.h"
+#include "Models/AffineNet.h"
+
+int main()
+{
+    using namespace StaticNet;
+
+    using Conv = Conv2D<Tensor<float, 4, 12, 12>, Tensor<float, 12, 8, 8>>;
+    static_assert(Conv::cost<1>().parameters == 12 * 4 * 5 * 5 + 12);
+    static_assert(Conv::cost<2>().forward_flops == 2 * Conv::cost<1>().forward_flops);
+    static_assert(Conv::cost<1>().cached_bytes == 8 * 8 * 4 * 5 * 5 * sizeof(float));
+
+    using Fc = Linear<Tensor<float, 192>, Tensor<float, 10>>;
+    static_assert(Fc::cost<1>().parameters == 192 * 10 + 10);
+    static_assert(Fc::cost<200>().forward_flops == 2 * 200 * 192 * 10 + 200 * 10);
+
+    constexpr ModuleCost lenet = LeNet::cost<200>();
+    static_assert(lenet.parameters == (4 * 25 + 4) + (12 * 100 + 12) + (192 * 10 + 10));
+    static_assert(lenet.parameter_bytes == lenet.parameters * sizeof(float));
+    static_assert(lenet.output_bytes == 200 * 10 * sizeof(float));
+    static_assert(lenet.peak_bytes >= lenet.cached_bytes);
+    static_assert(LeNet::cost<100>().peak_bytes < lenet.peak_bytes);
+
+    constexpr ModuleCost affine = AffineNet::cost<1>();
+    static_assert(affine.parameters == 784 * 300 + 300 + 300 * 200 + 200 + 200 * 10 + 10);
+
+    static_assert(largest_batch_within<LeNet, 1, 8, 32, 200>(LeNet::cost<32>().training_bytes()) == 32);
+    static_assert(largest_batch_within<LeNet, 8, 32, 200>(0) == 0);
+
+    LeNet model;
+    assert(model.parameters == lenet.parameters);
+    AffineNet affine_model;
+    assert(affine_model.parameters == affine.parameters);
+}
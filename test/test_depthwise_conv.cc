@@ -0,0 +1,90 @@
+#include <cassert>
+#include <cmath>
+
+#include "Modules/Conv2D.h"
+#include "Modules/DepthwiseConv2D.h"
+#include "Modules/GroupedConv2D.h"
+#include "ConvCheck.h"
+
+using namespace StaticNet;
+
+// Output channel f may only depend on the input channels of its group.
+template <class Conv, size_t C, size_t IH, size_t IW, size_t FN, size_t OH, size_t OW, class Group>
+void check_separable(Conv &conv, Group group)
+{
+    auto x = Tensor<float, 1, C, IH, IW>::random();
+    auto base = conv.forward(x);
+    for (size_t c = 0; c < C; c++)
+    {
+        Tensor<float, 1, C, IH, IW> perturbed;
+        perturbed = x;
+        for (size_t i = 0; i < IH; i++)
+            for (size_t j = 0; j < IW; j++)
+                perturbed[0][c][i][j] += 1.0f;
+
+        auto out = conv.forward(perturbed);
+        size_t wrong = 0;
+        for (size_t f = 0; f < FN; f++)
+        {
+            float diff = 0;
+            for (size_t i = 0; i < OH * OW; i++)
+                diff += std::fabs(out.data[f * OH * OW + i] - base.data[f * OH * OW + i]);
+            wrong += (diff > 0) != (c / (C / group.count) == group(f));
+        }
+        assert(wrong == 0);
+    }
+}
+
+struct Groups
+{
+    size_t count, filters;
+    size_t operator()(size_t f) const { return f / (filters / count); }
+};
+
+// A full-image window reduces each output to <w_f, x> + b_f, so one SGD step
+// with dout = 1 moves it by exactly -lr * (|x over f's inputs|^2 + 1).
+template <class Conv, size_t C, size_t H, size_t W, size_t FN, size_t Inputs>
+void check_weight_step(Conv &conv)
+{
+    auto x = Tensor<float, 1, C, H, W>::random();
+    auto before = conv.forward(x);
+    conv.backward(Tensor<float, 1, FN, 1, 1>(1.0f), 0.5f);
+    auto after = conv.forward(x);
+
+    size_t wrong = 0;
+    for (size_t f = 0; f < FN; f++)
+    {
+        size_t first = f / (FN / (C / Inputs)) * Inputs;
+        float norm = inner<Inputs * H * W>(x.data + first * H * W, x.data + first * H * W);
+        wrong += std::fabs(after.data[f] - (before.data[f] - 0.5f * (norm + 1))) >= 1e-3f * (1 + norm);
+    }
+    assert(wrong == 0);
+}
+
+int main()
+{
+    Module<float> root("Root");
+
+    // Depth multiplier 2, 3x3 "same" padding with stride 2.
+    DepthwiseConv2D<Tensor<float, 3, 9, 8>, Tensor<float, 6, 5, 4>, Window2D<3, 3, 2, 2, 1, 1>> depthwise(&root);
+    check_adjoint<Tensor<float, 2, 3, 9, 8>, Tensor<float, 2, 6, 5, 4>>(depthwise);
+    check_separable<decltype(depthwise), 3, 9, 8, 6, 5, 4>(depthwise, Groups{3, 6});
+
+    DepthwiseConv2D<Tensor<float, 4, 7, 7>, Tensor<float, 4, 3, 3>, Window2D<3, 3, 1, 1, 0, 0, 2, 2>> dilated(&root);
+    check_adjoint<Tensor<float, 2, 4, 7, 7>, Tensor<float, 2, 4, 3, 3>>(dilated);
+
+    DepthwiseConv2D<Tensor<float, 2, 5, 4>, Tensor<float, 4, 1, 1>> depthwise_full(&root);
+    check_weight_step<decltype(depthwise_full), 2, 5, 4, 4, 1>(depthwise_full);
+
+    GroupedConv2D<2, Tensor<float, 4, 8, 7>, Tensor<float, 6, 4, 4>, Window2D<3, 3, 2, 2, 1, 1>> grouped(&root);
+    check_adjoint<Tensor<float, 2, 4, 8, 7>, Tensor<float, 2, 6, 4, 4>>(grouped);
+    check_separable<decltype(grouped), 4, 8, 7, 6, 4, 4>(grouped, Groups{2, 6});
+
+    GroupedConv2D<2, Tensor<float, 4, 3, 3>, Tensor<float, 4, 1, 1>> grouped_full(&root);
+    check_weight_step<decltype(grouped_full), 4, 3, 3, 4, 2>(grouped_full);
+
+    // Same receptive field, a fraction of the dense work.
+    using Dense = Conv2D<Tensor<float, 32, 16, 16>, Tensor<float, 32, 16, 16>, Window2D<3, 3, 1, 1, 1, 1>>;
+    using Depthwise = DepthwiseConv2D<Tensor<float, 32, 16, 16>, Tensor<float, 32, 16, 16>, Window2D<3, 3, 1, 1, 1, 1>>;
+    static_assert(Dense::cost<1>().forward_flops > 16 * Depthwise::cost<1>().forward_flops);
+}
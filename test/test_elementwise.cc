@@ -0,0 +1,149 @@
+#include <cassert>
+#include <cmath>
+#include <functional>
+
+#include "Tensor.h"
+
+using namespace StaticNet;
+
+// Dense [4, 3, 8] tensors next to [4, 3, 8] views of the middle rows of a
+// [4, 6, 8] origin, which take the strided branch of every operator. Each
+// result is checked element by element against a naive loop.
+
+using Dense = Tensor<float, 4, 3, 8>;
+
+template <class A, class B, class F>
+void expect_each(const A &actual, const B &input, F expected)
+{
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 3; j++)
+            for (size_t k = 0; k < 8; k++)
+                assert(actual[i][j][k] == expected(input[i][j][k]));
+}
+
+template <class View>
+void test_operators(View a)
+{
+    auto scaled = a * 2.5f;
+    expect_each(scaled, a, [](float x) { return x * 2.5f; });
+
+    auto divided = a / 4.0f;
+    expect_each(divided, a, [](float x) { return x / 4.0f; });
+
+    auto negated = -a;
+    expect_each(negated, a, [](float x) { return -x; });
+
+    auto mapped = a.template map<float>([](float x) { return x * x + 1.0f; });
+    expect_each(mapped, a, [](float x) { return x * x + 1.0f; });
+
+    Dense before;
+    before = a;
+    expect_each(before, a, [](float x) { return x; });
+
+    a *= 3.0f;
+    expect_each(a, before, [](float x) { return x * 3.0f; });
+    a /= 3.0f;
+    expect_each(a, before, [](float x) { return x * 3.0f / 3.0f; });
+
+    auto flat = a.template reshape<12, 8>();
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 3; j++)
+            for (size_t k = 0; k < 8; k++)
+                assert(flat[i * 3 + j][k] == a[i][j][k]);
+
+    auto squared = hadamard(a, a);
+    expect_each(squared, a, [](float x) { return x * x; });
+
+    // Rank 1: the flat equality kernel, both ways.
+    before = a;
+    assert(a[1][2] == before[1][2]);
+    before[1][2][5] += 1.0f;
+    assert(!(a[1][2] == before[1][2]));
+}
+
+void test_assign()
+{
+    auto origin = Tensor<float, 4, 6, 8>::random();
+    auto source = Dense::random();
+
+    // Dense into strided and strided into dense.
+    auto view = origin.slice<4, 3, 8>({0, 2, 0});
+    view = source;
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 6; j++)
+            for (size_t k = 0; k < 8; k++)
+                if (j >= 2 && j < 5)
+                    assert(origin[i][j][k] == source[i][j - 2][k]);
+
+    Dense copy;
+    copy = origin.slice<4, 3, 8>({0, 2, 0});
+    expect_each(copy, source, [](float x) { return x; });
+}
+
+void test_hadamard()
+{
+    auto a = Tensor<float, 16>::random(), b = Tensor<float, 16>::random();
+    auto small = hadamard(a, b);
+    for (size_t i = 0; i < 16; i++)
+        assert(small[i] == a[i] * b[i]);
+
+    // Rank 3 at and above SmallThreshold, dense with strided.
+    auto cube = Tensor<float, 2, 4, 2>::random();
+    auto strided = cube.slice<2, 2, 2>({0, 1, 0});
+    auto c = Tensor<float, 2, 2, 2>::random();
+    auto product = hadamard(strided, c);
+    for (size_t i = 0; i < 2; i++)
+        for (size_t j = 0; j < 2; j++)
+            for (size_t k = 0; k < 2; k++)
+                assert(product[i][j][k] == cube[i][j + 1][k] * c[i][j][k]);
+
+    auto origin = Tensor<float, 4, 6, 8>::random();
+    auto x = Dense::random();
+    auto view = origin.slice<4, 3, 8>({0, 3, 0});
+    auto large = hadamard(x, view);
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 3; j++)
+            for (size_t k = 0; k < 8; k++)
+                assert(large[i][j][k] == x[i][j][k] * origin[i][j + 3][k]);
+}
+
+// Rows of 100 take Kernels::softmax rather than the Small path.
+template <class Src, class Out>
+void expect_softmax(const Src &src, const Out &out)
+{
+    for (size_t r = 0; r < 3; r++)
+    {
+        float top = src[r][0][0];
+        for (size_t i = 1; i < 100; i++)
+            top = std::max(top, (float)src[r][0][i]);
+        float sum = 0.0f;
+        for (size_t i = 0; i < 100; i++)
+            sum += std::exp(src[r][0][i] - top);
+        for (size_t i = 0; i < 100; i++)
+            assert(std::fabs(out[r][0][i] - std::exp(src[r][0][i] - top) / sum) < 1e-6f);
+    }
+}
+
+void test_softmax()
+{
+    auto dense = Tensor<float, 3, 1, 100>::random() * 8.0f;
+    expect_softmax(dense, softmax(dense));
+
+    auto origin = Tensor<float, 3, 2, 100>::random() * 8.0f;
+    auto view = origin.slice<3, 1, 100>({0, 1, 0});
+    expect_softmax(view, softmax(view));
+}
+
+int main()
+{
+    auto dense = Dense::random();
+    test_operators<Dense &>(dense);
+
+    auto origin = Tensor<float, 4, 6, 8>::random();
+    test_operators(origin.slice<4, 3, 8>({0, 1, 0}));
+
+    test_assign();
+    test_hadamard();
+    test_softmax();
+    return 0;
+}
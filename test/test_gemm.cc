@@ -0,0 +1,221 @@
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "Modules/Linear.h"
+
+using namespace StaticNet;
+
+bool close(float a, float b)
+{
+    return std::fabs(a - b) < 1e-4f * (1 + std::fabs(b));
+}
+
+// c = alpha * a b + beta * c with a [m, k] and b [k, n], in doubles.
+std::vector<float> naive(const std::vector<float> &a, const std::vector<float> &b, std::vector<float> c,
+                         size_t m, size_t k, size_t n, float alpha, float beta)
+{
+    for (size_t i = 0; i < m; i++)
+        for (size_t j = 0; j < n; j++)
+        {
+            double sum = 0;
+            for (size_t p = 0; p < k; p++)
+                sum += (double)a[i * k + p] * b[p * n + j];
+            c[i * n + j] = (float)(alpha * sum + beta * c[i * n + j]);
+        }
+    return c;
+}
+
+std::vector<float> transposed(const std::vector<float> &a, size_t rows, size_t cols)
+{
+    std::vector<float> result(a.size());
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = 0; j < cols; j++)
+            result[j * rows + i] = a[i * cols + j];
+    return result;
+}
+
+std::vector<float> random_vector(size_t size)
+{
+    std::vector<float> result(size);
+    for (auto &v : result)
+        v = Random::rand<float>();
+    return result;
+}
+
+// Odd sizes cross every tile boundary of the blocked kernels.
+void test_gemm(size_t m, size_t k, size_t n, float alpha, float beta)
+{
+    auto a = random_vector(m * k), b = random_vector(k * n), c = random_vector(m * n);
+    auto expected = naive(a, b, c, m, k, n, alpha, beta);
+
+    auto result = c;
+    Kernels::gemm(a.data(), b.data(), result.data(), m, k, n, alpha, beta);
+    for (size_t i = 0; i < m * n; i++)
+        assert(close(result[i], expected[i]));
+
+    auto at = transposed(a, m, k);
+    result = c;
+    Kernels::gemm_tn(at.data(), b.data(), result.data(), m, k, n, alpha, beta);
+    for (size_t i = 0; i < m * n; i++)
+        assert(close(result[i], expected[i]));
+
+    auto bt = transposed(b, k, n);
+    result = c;
+    Kernels::gemm_nt(a.data(), bt.data(), result.data(), m, k, n, alpha, beta);
+    for (size_t i = 0; i < m * n; i++)
+        assert(close(result[i], expected[i]));
+}
+
+void test_dot()
+{
+    auto a = Tensor<float, 5, 7>::random();
+    auto b = Tensor<float, 7, 3>::random();
+
+    auto c = dot(a, b);
+    auto tn = dot_tn(a.transpose<1, 0>(), b);
+    auto nt = dot_nt(a, b.transpose<1, 0>());
+    for (size_t i = 0; i < 5; i++)
+        for (size_t j = 0; j < 3; j++)
+        {
+            float sum = 0;
+            for (size_t p = 0; p < 7; p++)
+                sum += a[i][p] * b[p][j];
+            assert(close(c[i][j], sum));
+            assert(close(tn[i][j], sum));
+            assert(close(nt[i][j], sum));
+        }
+}
+
+// Every batch entry matches its own gemm, for strided and broadcast (stride 0)
+// operands, both below and above the threading threshold.
+void test_batched_gemm(size_t batch, size_t m, size_t k, size_t n, bool shared_b)
+{
+    const size_t stride_b = shared_b ? 0 : k * n;
+    auto a = random_vector(batch * m * k), b = random_vector(shared_b ? k * n : batch * k * n);
+    auto c = random_vector(batch * m * n);
+
+    std::vector<float> expected;
+    for (size_t p = 0; p < batch; p++)
+    {
+        std::vector<float> ap(a.begin() + p * m * k, a.begin() + (p + 1) * m * k);
+        std::vector<float> bp(b.begin() + p * stride_b, b.begin() + p * stride_b + k * n);
+        std::vector<float> cp(c.begin() + p * m * n, c.begin() + (p + 1) * m * n);
+        auto product = naive(ap, bp, cp, m, k, n, 0.5f, 1.0f);
+        expected.insert(expected.end(), product.begin(), product.end());
+    }
+
+    auto result = c;
+    Kernels::batched_gemm(a.data(), m * k, b.data(), stride_b, result.data(), m * n, batch, m, k, n, 0.5f, 1.0f);
+    for (size_t i = 0; i < batch * m * n; i++)
+        assert(close(result[i], expected[i]));
+
+    std::vector<float> at, bt;
+    for (size_t p = 0; p < batch; p++)
+    {
+        auto ap = transposed(std::vector<float>(a.begin() + p * m * k, a.begin() + (p + 1) * m * k), m, k);
+        at.insert(at.end(), ap.begin(), ap.end());
+    }
+    for (size_t p = 0; p < (shared_b ? 1 : batch); p++)
+    {
+        auto bp = transposed(std::vector<float>(b.begin() + p * k * n, b.begin() + (p + 1) * k * n), k, n);
+        bt.insert(bt.end(), bp.begin(), bp.end());
+    }
+
+    result = c;
+    Kernels::batched_gemm_tn(at.data(), m * k, b.data(), stride_b, result.data(), m * n, batch, m, k, n, 0.5f, 1.0f);
+    for (size_t i = 0; i < batch * m * n; i++)
+        assert(close(result[i], expected[i]));
+
+    result = c;
+    Kernels::batched_gemm_nt(a.data(), m * k, bt.data(), stride_b, result.data(), m * n, batch, m, k, n, 0.5f, 1.0f);
+    for (size_t i = 0; i < batch * m * n; i++)
+        assert(close(result[i], expected[i]));
+}
+
+void test_batched_dot()
+{
+    auto a = Tensor<float, 4, 5, 7>::random();
+    auto b = Tensor<float, 4, 7, 3>::random();
+    auto shared = Tensor<float, 7, 3>::random();
+
+    auto c = batched_dot(a, b);
+    auto s = batched_dot(a, shared);
+    auto nt = batched_dot_nt(a, b.transpose<0, 2, 1>());
+    for (size_t p = 0; p < 4; p++)
+    {
+        auto expected = dot(a[p], b[p]);
+        auto expected_shared = dot(a[p], shared);
+        for (size_t i = 0; i < 5; i++)
+            for (size_t j = 0; j < 3; j++)
+            {
+                assert(close(c[p][i][j], expected[i][j]));
+                assert(close(nt[p][i][j], expected[i][j]));
+                assert(close(s[p][i][j], expected_shared[i][j]));
+            }
+    }
+}
+
+// The fused kernel must match the unfused dx, dW and db formulation.
+template <size_t Batch, size_t In, size_t Out>
+void test_linear_backward()
+{
+    auto x = Tensor<float, Batch, In>::random();
+    auto dy = Tensor<float, Batch, Out>::random();
+    auto w = Tensor<float, In, Out>::random();
+    auto bias = Tensor<float, Out>::random();
+    const float rate = 0.25f;
+
+    auto dx_expected = dot_nt(dy, w);
+    auto dw = dot_tn(x, dy);
+    Tensor<float, In, Out> w_expected;
+    w_expected = w;
+    w_expected -= dw * rate;
+    Tensor<float, Out> bias_expected;
+    bias_expected = bias;
+    for (size_t b = 0; b < Batch; b++)
+        for (size_t o = 0; o < Out; o++)
+            bias_expected[o] -= rate * dy[b][o];
+
+    Tensor<float, Batch, In> dx;
+    Kernels::linear_backward(x.data, dy.data, w.data, bias.data, dx.data, Batch, In, Out, rate);
+
+    for (size_t i = 0; i < Batch * In; i++)
+        assert(close(dx.data[i], dx_expected.data[i]));
+    for (size_t i = 0; i < In * Out; i++)
+        assert(close(w.data[i], w_expected.data[i]));
+    for (size_t i = 0; i < Out; i++)
+        assert(close(bias.data[i], bias_expected.data[i]));
+}
+
+int main()
+{
+    test_gemm(1, 1, 1, 1.0f, 0.0f);
+    test_gemm(37, 131, 19, 1.0f, 0.0f);
+    test_gemm(65, 257, 517, -0.5f, 1.0f);
+    test_gemm(3, 5, 600, 2.0f, 0.5f);
+
+    test_dot();
+
+    test_batched_gemm(1, 3, 4, 5, false);
+    test_batched_gemm(7, 9, 13, 6, false);
+    test_batched_gemm(7, 9, 13, 6, true);
+    test_batched_gemm(3, 70, 90, 40, false);
+    test_batched_gemm(200, 4, 8, 12, true);
+
+    test_batched_dot();
+
+    test_linear_backward<1, 1, 1>();
+    test_linear_backward<13, 17, 5>();
+    test_linear_backward<64, 300, 40>();
+
+    Linear<Tensor<float, 9>, Tensor<float, 4>> linear(nullptr);
+    auto x = Tensor<float, 6, 9>::random();
+    auto before = linear.forward(x);
+    linear.backward<6>(Tensor<float, 6, 4>(0.0f), 1.0f);
+    auto after = linear.forward(x);
+    for (size_t i = 0; i < 6 * 4; i++)
+        assert(before.data[i] == after.data[i]);
+
+    return 0;
+}
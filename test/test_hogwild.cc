@@ -0,0 +1,117 @@
+#include <cassert>
+#include <vector>
+
+#include "Defines.h"
+#include "Modules/Linear.h"
+#include "Modules/ReLU.h"
+#include "Utils/Hogwild.h"
+
+using namespace StaticNet;
+
+constexpr size_t Features = 16;
+constexpr size_t Classes = 4;
+constexpr size_t Batch = 16;
+constexpr size_t Threads = 4;
+
+class Net : public Module<float>
+{
+public:
+    Net() : Module<float>("Net"), fc1(this), relu(this), fc2(this) {}
+
+    template <size_t B>
+    Tensor<float, B, Classes> forward(const Tensor<float, B, Features> &input)
+    {
+        return fc2.forward(relu.forward(fc1.forward(input)));
+    }
+
+    template <size_t B>
+    Tensor<float, B, Features> backward(const Tensor<float, B, Classes> &delta, float learningRate)
+    {
+        return fc1.backward(relu.backward(fc2.backward(delta, learningRate), learningRate), learningRate);
+    }
+
+private:
+    Linear<Tensor<float, Features>, Tensor<float, 32>> fc1;
+    ReLU<Tensor<float, 32>> relu;
+    Linear<Tensor<float, 32>, Tensor<float, Classes>> fc2;
+};
+
+// Gaussian-ish blobs around one random prototype per class.
+void make_batches(size_t count, std::vector<Tensor<float, Batch, Features>> &inputs, std::vector<Tensor<bool, Batch, Classes>> &labels)
+{
+    Tensor<float, Classes, Features> prototypes;
+    for (size_t c = 0; c < Classes; c++)
+        for (size_t f = 0; f < Features; f++)
+            prototypes[c][f] = Random::rand<float>() * 8.0f;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Tensor<float, Batch, Features> input;
+        Tensor<bool, Batch, Classes> label(false);
+        for (size_t b = 0; b < Batch; b++)
+        {
+            size_t c = (i * Batch + b) % Classes;
+            label[b][c] = true;
+            for (size_t f = 0; f < Features; f++)
+                input[b][f] = prototypes[c][f] + Random::rand<float>();
+        }
+        inputs.push_back(input);
+        labels.push_back(label);
+    }
+}
+
+float accuracy(Net &model, const std::vector<Tensor<float, Batch, Features>> &inputs, const std::vector<Tensor<bool, Batch, Classes>> &labels)
+{
+    size_t correct = 0;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        auto output = model.forward(inputs[i]);
+        for (size_t b = 0; b < Batch; b++)
+            correct += argmax(output[b]) == argmax(labels[i][b]);
+    }
+    return (float)correct / (inputs.size() * Batch);
+}
+
+int main()
+{
+    std::vector<Tensor<float, Batch, Features>> inputs;
+    std::vector<Tensor<bool, Batch, Classes>> labels;
+    make_batches(64, inputs, labels);
+
+    // Saved activations are per lane: with a zero learning rate, concurrent
+    // workers must produce exactly the gradients of a serial run.
+    {
+        Net model;
+        auto delta = Tensor<float, Batch, Classes>::random();
+        std::vector<Tensor<float, Batch, Features>> serial(inputs.size()), parallel(inputs.size());
+
+        train_hogwild(model, 1, inputs.size(), [&](size_t i) {
+            model.forward(inputs[i]);
+            serial[i] = model.backward(delta, 0.0f);
+        });
+        train_hogwild(model, Threads, inputs.size(), [&](size_t i) {
+            model.forward(inputs[i]);
+            parallel[i] = model.backward(delta, 0.0f);
+        });
+
+        for (size_t i = 0; i < inputs.size(); i++)
+            for (size_t j = 0; j < Batch * Features; j++)
+                assert(serial[i].data[j] == parallel[i].data[j]);
+
+        // Every worker's lane is freed once the run is over.
+        assert(model.memory_bytes() == 0);
+    }
+
+    // Racy updates still converge on an easy problem.
+    {
+        Net model;
+        for (size_t epoch = 0; epoch < 10; epoch++)
+            train_hogwild(model, Threads, inputs.size(), [&](size_t i) {
+                auto result = model.forward(inputs[i]).apply(Defines::Softmax<Classes>);
+                model.backward(result - labels[i], 0.1f);
+            });
+        assert(accuracy(model, inputs, labels) > 0.9f);
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cassert>
+
+#include "Tensor.h"
+
+int main()
+{
+    using namespace StaticNet;
+
+    // 3x2 window, stride (2, 1), one row of padding, column dilation 2.
+    using Window = Window2D<3, 2, 2, 1, 1, 0, 1, 2>;
+    constexpr size_t Batch = 2, C = 2, IH = 5, IW = 6;
+    constexpr size_t OH = Window::output_h(IH), OW = Window::output_w(IW);
+    static_assert(OH == 3 && OW == 4);
+
+    Tensor<int, Batch, C, IH, IW> input;
+    for (size_t i = 0; i < Batch * C * IH * IW; i++)
+        input.data[i] = (int)i + 1;
+
+    auto col = im2col<Window>(input);
+    for (size_t b = 0; b < Batch; b++)
+        for (size_t oy = 0; oy < OH; oy++)
+            for (size_t ox = 0; ox < OW; ox++)
+                for (size_t c = 0; c < C; c++)
+                    for (size_t ky = 0; ky < 3; ky++)
+                        for (size_t kx = 0; kx < 2; kx++)
+                        {
+                            long y = (long)(oy * 2 + ky) - 1, x = (long)(ox + kx * 2);
+                            int expected = y >= 0 && y < (long)IH ? input[b][c][y][x] : 0;
+                            assert(col[(b * OH + oy) * OW + ox][(c * 3 + ky) * 2 + kx] == expected);
+                        }
+
+    // col2im is the adjoint of im2col: <im2col(x), y> == <x, col2im(y)>.
+    Tensor<int, Batch * OH * OW, C * 3 * 2> grad;
+    for (size_t i = 0; i < Batch * OH * OW * C * 3 * 2; i++)
+        grad.data[i] = (int)(i * 7 % 11) - 5;
+
+    auto image = col2im<Window, IH, IW>(grad);
+    long lhs = 0, rhs = 0;
+    for (size_t i = 0; i < Batch * OH * OW * C * 3 * 2; i++)
+        lhs += (long)col.data[i] * grad.data[i];
+    for (size_t i = 0; i < Batch * C * IH * IW; i++)
+        rhs += (long)input.data[i] * image.data[i];
+    assert(lhs == rhs);
+
+    // 2x2 taps dilated to span 3x3, stride 2, one pixel of padding, by hand.
+    Tensor<int, 1, 1, 4, 4> small;
+    for (size_t i = 0; i < 16; i++)
+        small.data[i] = (int)i + 1;
+    Tensor<int, 4, 4> patches = im2col<Window2D<2, 2, 2, 2, 1, 1, 2, 2>>(small);
+    Tensor<int, 4, 4> expected_patches = {{0, 0, 0, 6}, {0, 0, 6, 8}, {0, 6, 0, 14}, {6, 8, 14, 16}};
+    assert(std::equal(patches.data, patches.data + 16, expected_patches.data));
+}
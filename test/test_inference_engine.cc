@@ -0,0 +1,86 @@
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+#include "Models/AffineNet.h"
+#include "Utils/InferenceEngine.h"
+
+constexpr size_t Clients = 4;
+constexpr size_t RequestsPerClient = 16;
+
+int main()
+{
+    using namespace StaticNet;
+    using Engine = InferenceEngine<AffineNet, Tensor<float, 784>, Tensor<float, 10>, 1, 8, 32, 200>;
+
+    assert(Engine::select_batch(1, 200) == 1);
+    assert(Engine::select_batch(5, 200) == 8);
+    assert(Engine::select_batch(33, 200) == 200);
+    assert(Engine::select_batch(33, 32) == 32);
+    assert(Engine::select_batch(200, 200) == 200);
+    assert(Engine::select_batch(5, 4) == 1);
+    using Coarse = InferenceEngine<AffineNet, Tensor<float, 784>, Tensor<float, 10>, 8, 32>;
+    assert(Coarse::select_batch(3, 4) == 0);
+
+    AffineNet model;
+
+    // A limit below every compiled batch size is rejected up front.
+    {
+        InferenceOptions options;
+        options.max_batch = 4;
+        try
+        {
+            Coarse engine(model, options);
+            assert(!"max_batch below every compiled batch size was accepted");
+        }
+        catch (const std::invalid_argument &)
+        {
+        }
+    }
+
+    std::vector<Tensor<float, 784>> samples;
+    for (size_t i = 0; i < Clients * RequestsPerClient; i++)
+        samples.push_back(Tensor<float, 784>::random());
+
+    std::vector<Tensor<float, 10>> results(samples.size());
+    InferenceStats stats;
+
+    {
+        InferenceOptions options;
+        options.max_delay = std::chrono::microseconds(500);
+        Engine engine(model, options);
+
+        std::vector<std::thread> clients;
+        for (size_t c = 0; c < Clients; c++)
+            clients.emplace_back([&, c]() {
+                for (size_t r = 0; r < RequestsPerClient; r++)
+                {
+                    size_t idx = c * RequestsPerClient + r;
+                    results[idx] = engine.submit(samples[idx]).get();
+                }
+            });
+
+        for (auto &client : clients)
+            client.join();
+
+        stats = engine.stats();
+    }
+
+    assert(stats.requests == samples.size());
+    assert(stats.batches <= samples.size());
+
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        Tensor<float, 1, 784> single;
+        single[0] = samples[i];
+        auto expected = model.forward<1>(single);
+        for (size_t j = 0; j < 10; j++)
+            assert(std::fabs(expected[0][j] - results[i][j]) < 1e-4f);
+    }
+
+    // Every batch held at least one request and at most the largest
+    // compiled size, padding included.
+    assert(stats.batches > 0);
+    assert(stats.requests + stats.padded_rows >= stats.batches);
+    assert(stats.requests + stats.padded_rows <= stats.batches * 200);
+}
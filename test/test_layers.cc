@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+
+#include "Layers.h"
+
+using namespace StaticNet;
+
+void test_sigmoid()
+{
+    Sigmoid<3, 2> sigmoid;
+    Tensor<float, 2, 3> x = {{0.f, 1.f, -2.f}, {3.f, -0.5f, 0.25f}};
+    auto y = sigmoid.Forward(x);
+    for (size_t i = 0; i < 6; i++)
+        assert(std::abs(y.data[i] - Defines::Sigmoid(x.data[i])) < 1e-6f);
+
+    // Backward uses the saved output, which Forward must not hand away.
+    Tensor<float, 2, 3> ones(1.f);
+    auto delta = sigmoid.Backward(ones, 0.f);
+    for (size_t i = 0; i < 6; i++)
+        assert(std::abs(delta.data[i] - Defines::SigmoidDerivative(x.data[i])) < 1e-6f);
+}
+
+void test_static_layer()
+{
+    Dense<8, 4, 5> dense;
+    Sigmoid<4, 5> sigmoid;
+
+    Layer layer(&dense, &sigmoid);
+    static_assert(std::is_same_v<decltype(layer), Layer<Dense<8, 4, 5>, Sigmoid<4, 5>>>);
+    static_assert(std::is_same_v<decltype(layer)::OutputTensor, Tensor<float, 5, 4>>);
+
+    // The same stages behind the runtime interfaces give the same results.
+    PolymorphicLayer<8, 4, 5> dynamic(&dense, &sigmoid);
+
+    Tensor<float, 5, 8> x;
+    for (size_t i = 0; i < 40; i++)
+        x.data[i] = std::sin((float)i);
+
+    auto y = layer(x);
+    auto z = dynamic(x);
+    assert(std::equal(y.data, y.data + 20, z.data));
+
+    Tensor<float, 5, 4> grad(0.5f);
+    auto dx = layer.Backward(grad, 0.f);
+    auto dz = dynamic.Backward(grad, 0.f);
+    assert(std::equal(dx.data, dx.data + 40, dz.data));
+
+    // Training through the static layer moves the output.
+    for (int step = 0; step < 10; step++)
+    {
+        layer.Forward(x);
+        layer.Backward(grad, 0.1f);
+    }
+    auto trained = layer(x);
+    assert(!std::equal(trained.data, trained.data + 20, y.data));
+}
+
+int main()
+{
+    test_sigmoid();
+    test_static_layer();
+}
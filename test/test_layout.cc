@@ -0,0 +1,97 @@
+#include <cassert>
+#include <cmath>
+
+#include "Modules/Conv2D.h"
+#include "Modules/AvgPool2D.h"
+#include "Modules/MaxPool2D.h"
+#include "ConvCheck.h"
+
+using namespace StaticNet;
+
+constexpr size_t Batch = 2, C = 16, H = 6, W = 4;
+
+template <size_t Size>
+bool close(const float *a, const float *b)
+{
+    for (size_t i = 0; i < Size; i++)
+        if (std::fabs(a[i] - b[i]) > 1e-5f)
+            return false;
+    return true;
+}
+
+// Pooling must compute the same function in every layout.
+template <class Layout, template <class...> class Pool>
+void check_pool(const Tensor<float, Batch, C, H, W> &x, const Tensor<float, Batch, C, H / 2, W / 2> &dy)
+{
+    Module<float> root("Root");
+    Pool<Tensor<float, C, H, W>, Tensor<float, C, H / 2, W / 2>> reference(&root);
+    Pool<Tensor<float, C, H, W>, Tensor<float, C, H / 2, W / 2>, Layout> pool(&root);
+
+    auto expected = reference.forward(x);
+    auto expected_dx = reference.backward(dy, 0.0f);
+
+    auto y = pool.forward(reorder<NCHW, Layout, C, H, W>(x));
+    auto dx = pool.backward(reorder<NCHW, Layout, C, H / 2, W / 2>(dy), 0.0f);
+
+    auto y_nchw = reorder<Layout, NCHW, C, H / 2, W / 2>(y);
+    auto dx_nchw = reorder<Layout, NCHW, C, H, W>(dx);
+    assert(close<Batch * C * H / 2 * W / 2>(y_nchw.data, expected.data));
+    assert(close<Batch * C * H * W>(dx_nchw.data, expected_dx.data));
+}
+
+template <class Layout, size_t FN>
+void check_conv()
+{
+    Module<float> root("Root");
+
+    // Backward is the adjoint of forward's linear part.
+    Conv2D<Tensor<float, C, H, W>, Tensor<float, FN, 3, 2>, Window2D<3, 3, 2, 2, 1, 1>, Layout> conv(&root);
+    check_adjoint<LayoutTensor<Layout, float, Batch, C, H, W>, LayoutTensor<Layout, float, Batch, FN, 3, 2>>(conv);
+
+    // A full-image window reduces to <w_f, x> + b_f, so one step with
+    // dout = 1 moves every output by -lr * (|x|^2 + 1).
+    Conv2D<Tensor<float, C, H, W>, Tensor<float, FN, 1, 1>, Window2D<H, W>, Layout> full(&root);
+    auto image = LayoutTensor<Layout, float, 1, C, H, W>::random();
+    auto before = full.forward(image);
+    full.backward(LayoutTensor<Layout, float, 1, FN, 1, 1>(1.0f), 0.5f);
+    auto after = full.forward(image);
+    const float norm = inner<C * H * W>(image.data, image.data);
+    size_t wrong = 0;
+    for (size_t f = 0; f < FN; f++)
+        wrong += std::fabs(after.data[f] - (before.data[f] - 0.5f * (norm + 1))) >= 1e-3f * (1 + norm);
+    assert(wrong == 0);
+}
+
+int main()
+{
+    auto x = Tensor<float, Batch, C, H, W>::random();
+
+    static_assert(std::is_same_v<LayoutTensor<NHWC, float, Batch, C, H, W>, Tensor<float, Batch, H, W, C>>);
+    static_assert(std::is_same_v<LayoutTensor<NChw8c, float, Batch, C, H, W>, Tensor<float, Batch, 2, H, W, 8>>);
+    static_assert(std::is_same_v<LayoutTensor<NChw8c, float, Batch, 3, H, W>, Tensor<float, Batch, 1, H, W, 3>>);
+
+    auto nhwc = reorder<NCHW, NHWC, C, H, W>(x);
+    auto blocked = reorder<NHWC, NChw8c, C, H, W>(nhwc);
+    auto blocked16 = reorder<NChw8c, NChw16c, C, H, W>(blocked);
+    auto back = reorder<NChw16c, NCHW, C, H, W>(blocked16);
+    for (size_t b = 0; b < Batch; b++)
+        for (size_t c = 0; c < C; c++)
+            for (size_t h = 0; h < H; h++)
+                for (size_t w = 0; w < W; w++)
+                {
+                    assert(nhwc[b][h][w][c] == x[b][c][h][w]);
+                    assert(blocked[b][c / 8][h][w][c % 8] == x[b][c][h][w]);
+                    assert(back[b][c][h][w] == x[b][c][h][w]);
+                }
+
+    auto dy = Tensor<float, Batch, C, H / 2, W / 2>::random();
+    check_pool<NHWC, AvgPool2D>(x, dy);
+    check_pool<NChw8c, AvgPool2D>(x, dy);
+    check_pool<NHWC, MaxPool2D>(x, dy);
+    check_pool<NChw8c, MaxPool2D>(x, dy);
+
+    check_conv<NCHW, 16>();
+    check_conv<NHWC, 16>();
+    check_conv<NChw8c, 16>();
+    check_conv<NChw8c, 8>();
+}
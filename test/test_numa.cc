@@ -0,0 +1,71 @@
+#include <cassert>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "Tensor.h"
+
+using namespace StaticNet;
+
+int main()
+{
+    assert((Numa::parse_cpulist("0-3,8,10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    assert(Numa::parse_cpulist("").empty());
+
+    assert(Numa::nodes() >= 1);
+    assert(!Numa::cpus(0).empty());
+
+    // Scopes nest and restore the thread's policy.
+    assert(Numa::policy().placement == Numa::Placement::FirstTouch);
+    {
+        Numa::Scope weights({Numa::Placement::Interleave});
+        assert(Numa::policy().placement == Numa::Placement::Interleave);
+        {
+            Numa::Scope activations({Numa::Placement::Node, 0});
+            assert(Numa::policy().placement == Numa::Placement::Node);
+
+            // Placement must never change contents, whether or not the
+            // kernel lets us bind.
+            Tensor<float, 256, 256> local(2.0f);
+            for (size_t i = 0; i < 256 * 256; i++)
+                assert(local.data[i] == 2.0f);
+        }
+        assert(Numa::policy().placement == Numa::Placement::Interleave);
+
+        auto shared = Tensor<float, 300, 300>::random();
+        Tensor<float, 300, 300> copy;
+        copy = shared;
+        assert(copy.data[300 * 300 - 1] == shared.data[300 * 300 - 1]);
+    }
+    assert(Numa::policy().placement == Numa::Placement::FirstTouch);
+
+    // Binding moves pages that are already resident, as they are in a
+    // buffer recycled from the heap.
+    {
+        const int node = (int)Numa::nodes() - 1;
+        { Tensor<float, 512, 512> warm(1.0f); }
+        Tensor<float, 512, 512> recycled(1.0f);
+        if (Numa::bind(recycled.data, sizeof(float) * 512 * 512, {Numa::Placement::Node, node}))
+            assert(Numa::node_of(recycled.data + 256 * 512) == node);
+    }
+
+    // Small or unaligned ranges never reach the kernel.
+    float small[16];
+    assert(!Numa::bind(small, sizeof(small), {Numa::Placement::Interleave}));
+
+    // The policy is per thread.
+    Numa::Scope outer({Numa::Placement::Interleave});
+    std::thread([]() { assert(Numa::policy().placement == Numa::Placement::FirstTouch); }).join();
+
+#ifdef __linux__
+    const int cpu = Numa::cpus(0).front();
+    std::thread([cpu]() {
+        if (Numa::pin_current_thread({cpu}))
+            assert(sched_getcpu() == cpu);
+    }).join();
+#endif
+
+    return 0;
+}
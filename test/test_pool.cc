@@ -0,0 +1,73 @@
+#include <cassert>
+
+#include "Modules/AvgPool2D.h"
+#include "Modules/MaxPool2D.h"
+
+int main()
+{
+    using namespace StaticNet;
+
+    Module<int> root("Root");
+    AvgPool2D<Tensor<int, 1, 4, 4>, Tensor<int, 1, 2, 2>> avgpool(&root);
+    MaxPool2D<Tensor<int, 1, 4, 4>, Tensor<int, 1, 2, 2>> maxpool(&root);
+    AvgPool2D<Tensor<int, 2, 4, 6>, Tensor<int, 2, 2, 2>> avgpool_rect(&root);
+
+    Tensor<int, 1, 1, 4, 4> input = {{{
+        {1, 2, 3, 4},
+        {5, 6, 7, 8},
+        {9, 10, 11, 12},
+        {13, 16, 15, 14},
+    }}};
+
+    Tensor<int, 1, 1, 2, 2> avg_correct = {{{{3, 5}, {12, 13}}}};
+    auto avg = avgpool.forward(input);
+    assert(avg == avg_correct);
+    Tensor<int, 2, 2> generic = pool<int, 4, 2>(input[0][0], [](const Tensor<int, 2, 2> &t) {
+        return (t[0][0] + t[0][1] + t[1][0] + t[1][1]) / 4;
+    });
+    assert(avg[0][0] == generic);
+
+    Tensor<int, 1, 1, 2, 2> max_correct = {{{{6, 8}, {16, 15}}}};
+    auto max = maxpool.forward(input);
+    assert(max == max_correct);
+
+    Tensor<int, 1, 1, 2, 2> delta = {{{{1, 2}, {3, 4}}}};
+    Tensor<int, 1, 1, 4, 4> max_delta_correct = {{{
+        {0, 0, 0, 0},
+        {0, 1, 0, 2},
+        {0, 0, 0, 0},
+        {0, 3, 4, 0},
+    }}};
+    auto max_delta = maxpool.backward(delta, 0.0f);
+    assert(max_delta == max_delta_correct);
+
+    Tensor<int, 1, 1, 2, 2> avg_delta = {{{{4, 8}, {12, 16}}}};
+    Tensor<int, 1, 1, 4, 4> avg_delta_correct = {{{
+        {1, 1, 2, 2},
+        {1, 1, 2, 2},
+        {3, 3, 4, 4},
+        {3, 3, 4, 4},
+    }}};
+    auto avg_dx = avgpool.backward(avg_delta, 0.0f);
+    assert(avg_dx == avg_delta_correct);
+
+    Tensor<int, 3, 2, 4, 6> rect;
+    for (size_t b = 0; b < 3; b++)
+        for (size_t c = 0; c < 2; c++)
+            for (size_t y = 0; y < 4; y++)
+                for (size_t x = 0; x < 6; x++)
+                    rect[b][c][y][x] = b * 1000 + c * 100 + y * 6 + x;
+
+    auto rect_pooled = avgpool_rect.forward(rect);
+    for (size_t b = 0; b < 3; b++)
+        for (size_t c = 0; c < 2; c++)
+            for (size_t y = 0; y < 2; y++)
+                for (size_t x = 0; x < 2; x++)
+                {
+                    int sum = 0;
+                    for (size_t ky = 0; ky < 2; ky++)
+                        for (size_t kx = 0; kx < 3; kx++)
+                            sum += rect[b][c][y * 2 + ky][x * 3 + kx];
+                    assert(rect_pooled[b][c][y][x] == sum / 6);
+                }
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+#include "Models/LeNet.h"
+
+int main()
+{
+    using namespace StaticNet;
+
+    LeNet model;
+    auto input = Tensor<float, 2, 1, 28, 28>::random();
+
+    model.forward(input);
+    assert(model.profile.forward.load().calls == 0);
+
+    Profiler::enable(true);
+    auto output = model.forward(input);
+    model.backward(output, 0.0f);
+    Profiler::disable();
+
+    auto forward = model.profile.forward.load();
+    auto backward = model.profile.backward.load();
+    assert(forward.calls == 1);
+    assert(backward.calls == 1);
+    assert(forward.ticks > 0);
+    assert(forward.flops >= 2 * 2 * (24 * 24 * 4 * 25 + 8 * 8 * 12 * 100 + 192 * 10));
+    assert(forward.allocations > 0);
+
+    for (auto child : model.children)
+        assert(child->profile.forward.load().calls == 1);
+
+    bool found_dot = false, found_im2col = false;
+    for (const auto &[name, counters] : Profiler::kernels())
+    {
+        if (name == "dot")
+            found_dot = counters.calls > 0 && counters.flops > 0;
+        if (name == "im2col")
+            found_im2col = counters.calls == 2;
+    }
+    assert(found_dot);
+    assert(found_im2col);
+
+    std::ostringstream trace;
+    Profiler::write_chrome_trace(trace);
+    assert(trace.str().find("\"traceEvents\"") != std::string::npos);
+    assert(trace.str().find("Conv2D::forward") != std::string::npos);
+
+    print(model);
+    Profiler::print_kernels();
+
+    reset_profile(model);
+    Profiler::reset();
+    assert(model.profile.forward.load().calls == 0);
+    assert(Profiler::kernels().empty());
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Tensor.h"
+
+using namespace StaticNet;
+
+// Known-answer vectors from the Random123 distribution (kat_vectors).
+void test_philox()
+{
+    const uint32_t cases[3][10] = {
+        {0, 0, 0, 0, 0, 0, 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+        {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+        {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0, 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1},
+    };
+
+    for (const auto &c : cases)
+    {
+        uint32_t c0 = c[0], c1 = c[1], c2 = c[2], c3 = c[3];
+        Kernels::philox4x32(c0, c1, c2, c3, c[4], c[5]);
+        assert(c0 == c[6] && c1 == c[7] && c2 == c[8] && c3 == c[9]);
+    }
+}
+
+// Any range of a stream, computed in any chunking, gives the same words.
+void test_streams()
+{
+    constexpr size_t N = 5000;
+    std::vector<uint32_t> whole(N), parts(N);
+    Kernels::philox_words(whole.data(), 0, N, 7, 3);
+    Kernels::philox_words(parts.data(), 0, 1000, 7, 3);
+    Kernels::philox_words(parts.data() + 1000, 1000, N - 1000, 7, 3);
+    assert(whole == parts);
+
+    Random::Generator generator(3, 7);
+    for (size_t i = 0; i < 64; i++)
+        assert(generator.next() == whole[i]);
+
+    Random::Generator a = generator.split(0), b = generator.split(1);
+    size_t same = 0;
+    for (size_t i = 0; i < 64; i++)
+        same += a.next() == b.next();
+    assert(same < 4);
+}
+
+void test_reproducible()
+{
+    constexpr size_t N = 1 << 17;
+    std::vector<float> serial(N), parallel(N);
+
+#ifdef _OPENMP
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    Random::uniform(serial.data(), N, -1.0f, 1.0f, 11);
+    omp_set_num_threads(4);
+    Random::uniform(parallel.data(), N, -1.0f, 1.0f, 11);
+    omp_set_num_threads(threads);
+#else
+    Random::uniform(serial.data(), N, -1.0f, 1.0f, 11);
+    Random::uniform(parallel.data(), N, -1.0f, 1.0f, 11);
+#endif
+    assert(serial == parallel);
+
+    Random::seed(42);
+    auto first = Tensor<float, 64, 64>::random();
+    auto second = Tensor<float, 64, 64>::random();
+    Random::seed(42);
+    auto again = Tensor<float, 64, 64>::random();
+    assert(std::equal(first.data, first.data + 64 * 64, again.data));
+    assert(!std::equal(first.data, first.data + 64 * 64, second.data));
+
+    for (size_t i = 0; i < 64 * 64; i++)
+        assert(first.data[i] >= -0.25f && first.data[i] < 0.25f);
+
+    // Scalar draws, on this or a new thread, leave the bulk streams alone,
+    // and a thread's scalar sequence depends only on the seed and its index.
+    Random::seed(42);
+    std::vector<float> scalars(4), again_scalars(4);
+    std::thread([&]() {
+        Random::thread_index() = 1;
+        for (auto &x : scalars)
+            x = Random::rand<float>();
+    }).join();
+    Random::rand<float>();
+    auto after_scalars = Tensor<float, 64, 64>::random();
+    assert(std::equal(first.data, first.data + 64 * 64, after_scalars.data));
+
+    Random::seed(42);
+    std::thread([&]() {
+        Random::thread_index() = 1;
+        for (auto &x : again_scalars)
+            x = Random::rand<float>();
+    }).join();
+    assert(scalars == again_scalars);
+
+    // Threads without a key, and successive runs of a worker pool, each
+    // draw their own numbers.
+    std::vector<float> main_draws(4), plain_draws(4);
+    std::thread([&]() {
+        for (auto &x : plain_draws)
+            x = Random::rand<float>();
+    }).join();
+    for (auto &x : main_draws)
+        x = Random::rand<float>();
+    assert(plain_draws != main_draws);
+
+    std::vector<float> runs[2] = {std::vector<float>(4), std::vector<float>(4)};
+    for (auto &run : runs)
+        std::thread([&, key = Random::reserve_thread_keys(2)]() {
+            Random::thread_index() = key;
+            for (auto &x : run)
+                x = Random::rand<float>();
+        }).join();
+    assert(runs[0] != runs[1]);
+}
+
+void test_distributions()
+{
+    constexpr size_t N = 1 << 16;
+    std::vector<double> samples(N);
+
+    Random::normal(samples.data(), N, 0.0, 1.0);
+    double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / N;
+    double variance = 0.0;
+    for (double x : samples)
+        variance += (x - mean) * (x - mean) / N;
+    assert(std::fabs(mean) < 0.02 && std::fabs(variance - 1.0) < 0.03);
+
+    std::vector<unsigned char> mask(N);
+    Random::bernoulli(mask.data(), N, 0.3);
+    double kept = std::accumulate(mask.begin(), mask.end(), 0.0) / N;
+    assert(std::fabs(kept - 0.3) < 0.01);
+
+    Random::uniform(samples.data(), N, 2.0, 3.0);
+    assert(*std::min_element(samples.begin(), samples.end()) >= 2.0);
+    assert(*std::max_element(samples.begin(), samples.end()) < 3.0);
+
+    for (size_t i = 0; i < 1000; i++)
+    {
+        float f = Random::rand<float>();
+        double d = Random::rand<double>();
+        assert(f >= -0.25f && f < 0.25f && d >= 0.0 && d < 1.0);
+    }
+}
+
+void test_shuffle()
+{
+    std::vector<int> order(100), again;
+    std::iota(order.begin(), order.end(), 0);
+    again = order;
+
+    Random::shuffle(order.begin(), order.end(), Random::Generator(5));
+    Random::shuffle(again.begin(), again.end(), Random::Generator(5));
+    assert(order == again);
+
+    size_t moved = 0;
+    for (int i = 0; i < 100; i++)
+        moved += order[i] != i;
+    assert(moved > 50);
+
+    std::sort(order.begin(), order.end());
+    for (int i = 0; i < 100; i++)
+        assert(order[i] == i);
+}
+
+int main()
+{
+    test_philox();
+    test_streams();
+    test_reproducible();
+    test_distributions();
+    test_shuffle();
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <cassert>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Tensor.h"
+
+int main()
+{
+    using namespace StaticNet;
+
+    Tensor<int, 2, 3, 4> t;
+    for (size_t i = 0; i < 2; i++)
+        for (size_t j = 0; j < 3; j++)
+            for (size_t k = 0; k < 4; k++)
+                t[i][j][k] = i * 100 + j * 10 + k;
+
+    Tensor<int, 3, 4> sum0 = reduce_sum<0>(t);
+    Tensor<int, 2, 4> sum1 = reduce_sum<1>(t);
+    Tensor<int, 2, 3> sum2 = reduce_sum<2>(t);
+    for (size_t j = 0; j < 3; j++)
+        for (size_t k = 0; k < 4; k++)
+            assert(sum0[j][k] == (int)(100 + 2 * (j * 10 + k)));
+    for (size_t i = 0; i < 2; i++)
+        for (size_t k = 0; k < 4; k++)
+            assert(sum1[i][k] == (int)(3 * (i * 100 + k) + 30));
+    for (size_t i = 0; i < 2; i++)
+        for (size_t j = 0; j < 3; j++)
+            assert(sum2[i][j] == (int)(4 * (i * 100 + j * 10) + 6));
+    assert(t.reduce() == sum0);
+
+    Tensor<int, 3> channels = reduce_sum_except<1>(t);
+    for (size_t j = 0; j < 3; j++)
+        assert(channels[j] == sum0[j].reduce());
+
+    Tensor<int, 2, 3> max2 = reduce_max<2>(t);
+    Tensor<size_t, 3, 4> argmax0 = reduce_argmax<0>(t);
+    assert(max2[1][2] == 123);
+    assert(argmax0[2][3] == 1);
+    assert(reduce_argmax<0>(t[1][2]) == 3);
+
+    Tensor<float, 2, 4> mean = reduce_mean<1>(t.map<float>([](int x) { return (float)x; }));
+    assert(mean[1][3] == 113.0f);
+
+    Tensor<int, 6, 6> window_source;
+    for (size_t i = 0; i < 6; i++)
+        for (size_t j = 0; j < 6; j++)
+            window_source[i][j] = i * 6 + j;
+    auto window = window_source.slice<2, 3>({1, 2});
+    static_assert(!decltype(window)::contiguous());
+    Tensor<int, 3> window_sum = reduce_sum<0>(window);
+    Tensor<int, 3> window_sum_correct = {8 + 14, 9 + 15, 10 + 16};
+    assert(window_sum == window_sum_correct);
+
+    // A reshaped view keeping the trailing dim is dense and reduced in place.
+    auto flat = t.reshape_ref<6, 4>();
+    static_assert(decltype(flat)::contiguous());
+    Tensor<int, 4> flat_sum = reduce_sum<0>(flat);
+    for (size_t k = 0; k < 4; k++)
+        assert(flat_sum[k] == sum0[0][k] + sum0[1][k] + sum0[2][k]);
+
+    // One that does not is read through operator[], by the kernels too.
+    auto regrouped = t.reshape_ref<4, 6>();
+    static_assert(!decltype(regrouped)::contiguous());
+    Tensor<int, 4, 6> copied = regrouped + Tensor<int, 4, 6>(0);
+    Tensor<int, 4> row_sums = reduce_sum<1>(regrouped);
+    for (size_t i = 0; i < 4; i++)
+    {
+        int row_sum = 0;
+        for (size_t j = 0; j < 6; j++)
+        {
+            assert(copied[i][j] == regrouped[i][j]);
+            row_sum += regrouped[i][j];
+        }
+        assert(row_sums[i] == row_sum);
+    }
+
+    Tensor<int, 4, 5> preallocated(-1);
+    reduce_sum<0>(t, preallocated.slice<3, 4>({1, 1}));
+    assert(preallocated[0][0] == -1);
+    assert(preallocated[1][0] == -1);
+    assert(preallocated[3][4] == sum0[2][3]);
+
+    constexpr size_t N = 1 << 20;
+    Tensor<float, N> ones(0.1f);
+    float naive = 0.0f;
+    for (size_t i = 0; i < N; i++)
+        naive += 0.1f;
+    float total = reduce_sum<0>(ones);
+    assert(std::fabs(total - 0.1 * N) < std::fabs(naive - 0.1 * N));
+    assert(std::fabs(total - 0.1 * N) < 1.0);
+
+    Tensor<float, N / 4, 4> columns(0.1f);
+    Tensor<float, 4> column_sums = reduce_sum<0>(columns);
+    for (size_t i = 0; i < 4; i++)
+        assert(std::fabs(column_sums[i] - 0.1 * N / 4) < 0.1);
+
+#ifdef _OPENMP
+    // More threads than partial sums still covers the whole row.
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(300);
+    Tensor<int, 1, N> long_row(1);
+    Tensor<int, 1> long_sum = reduce_sum<1>(long_row);
+    omp_set_num_threads(threads);
+    assert(long_sum[0] == (int)N);
+#endif
+}
@@ -53,4 +53,15 @@ int main() {
     auto window_reshape_test = window_test_5.template reshape<4>();
     Tensor<int, 4> window_reshape_test_correct = { 2, 3, 6, 7 };
     assert(window_reshape_test == window_reshape_test_correct);
+
+    // Assigning a row to a row of a same-shaped tensor copies elements
+    // rather than rebinding the view.
+    Tensor<int, 4, 4> rows;
+    rows[0] = test[2];
+    rows[1] = test[3];
+    test[3][0] = 0;
+    for (size_t i = 0; i < 8; i++)
+        assert(rows.data[i] == (int)i + 9);
+    for (size_t i = 8; i < 16; i++)
+        assert(rows.data[i] == 0);
 }
\ No newline at end of file
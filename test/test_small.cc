@@ -0,0 +1,104 @@
+#include <array>
+#include <cassert>
+#include <cmath>
+
+#include "Tensor.h"
+
+using namespace StaticNet;
+
+constexpr std::array<int, 4> a = {3, -1, 7, 7};
+constexpr std::array<int, 4> b = {2, 5, 1, 0};
+
+constexpr std::array<int, 4> added()
+{
+    std::array<int, 4> result{};
+    Kernels::Small<4>::zip(a.data(), b.data(), result.data(), [](int x, int y) { return x + y; });
+    return result;
+}
+
+// Both the unrolled and the looped Small<N> agree with a plain loop.
+template <size_t N>
+void check_size()
+{
+    auto x = Tensor<float, N>::random();
+    auto y = Tensor<float, N>::random();
+
+    double dot = 0;
+    size_t best = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        dot += (double)x[i] * y[i];
+        best = x[i] > x[best] ? i : best;
+    }
+    assert(std::fabs(Kernels::Small<N>::dot(x.data, y.data) - dot) < 1e-5);
+    assert(argmax(x) == best);
+
+    auto p = softmax(x);
+    float sum = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        sum += p[i];
+        assert(std::fabs(p[i] / p[best] - std::exp(x[i] - x[best])) < 1e-5f);
+    }
+    assert(std::fabs(sum - 1.0f) < 1e-5f);
+
+    Tensor<float, N> product = hadamard(x, y);
+    for (size_t i = 0; i < N; i++)
+        assert(product[i] == x[i] * y[i]);
+}
+
+// Small products skip GEMM; both sides of the cutoff match a plain loop.
+template <size_t M, size_t K, size_t N>
+void check_dot()
+{
+    auto x = Tensor<float, M, K>::random();
+    auto y = Tensor<float, K, N>::random();
+    auto z = dot(x, y);
+    for (size_t i = 0; i < M; i++)
+        for (size_t j = 0; j < N; j++)
+        {
+            double sum = 0;
+            for (size_t p = 0; p < K; p++)
+                sum += (double)x[i][p] * y[p][j];
+            assert(std::fabs(z[i][j] - sum) < 1e-4);
+        }
+}
+
+int main()
+{
+    // Everything but softmax is usable in constant expressions.
+    static_assert(Kernels::Small<4>::dot(a.data(), b.data()) == 6 - 5 + 7);
+    static_assert(Kernels::Small<4>::sum(a.data()) == 16);
+    static_assert(Kernels::Small<4>::max(a.data()) == 7);
+    static_assert(Kernels::Small<4>::argmax(a.data()) == 2);
+    static_assert(Kernels::Small<2>::dot(a.data(), b.data(), 2) == 3 * 2 + -1 * 1);
+    static_assert(added()[1] == 4 && added()[3] == 7);
+
+    check_size<1>();
+    check_size<10>();
+    check_size<Kernels::SmallThreshold>();
+    check_size<Kernels::SmallThreshold + 1>();
+    check_size<1000>();
+
+    check_dot<2, 2, 2>();
+    check_dot<1, 84, 10>();
+    check_dot<1, 64, 64>();
+    check_dot<1, 65, 64>();
+
+    // Row-wise softmax over a batch, and argmax of a row slice.
+    Tensor<float, 3, 4> logits = {{0, 0, 0, 0}, {1, 2, 3, 4}, {-5, 9, 9, 1}};
+    auto p = softmax(logits);
+    assert(std::fabs(p[0][2] - 0.25f) < 1e-6f);
+    assert(p[1][3] > p[1][2] && p[1][2] > p[1][1]);
+    assert(argmax(logits[2]) == 1);
+
+    // Tiny broadcasts take the unrolled path.
+    Tensor<int, 2, 3, 1> column = {{{1}, {2}, {3}}, {{4}, {5}, {6}}};
+    Tensor<int, 1, 2> row = {{10, 20}};
+    Tensor<int, 2, 3, 2> sum = column + row;
+    assert(sum[1][2][1] == 26 && sum[0][0][0] == 11);
+    sum -= row;
+    assert(sum[1][2][1] == 6 && sum[0][1][0] == 2);
+
+    return 0;
+}
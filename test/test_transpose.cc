@@ -2,9 +2,86 @@
 #include <iostream>
 #include "Tensor.h"
 
-int main() {
-    using namespace StaticNet;
+using namespace StaticNet;
+
+// Compares x.transpose<TDim...>() against index arithmetic on flat offsets.
+template <size_t... TDim, class T, size_t... D>
+void check_transpose(const Tensor<T, D...> &x)
+{
+    constexpr size_t rank = sizeof...(D);
+    constexpr size_t dims[] = {D...}, perm[] = {TDim...};
+    size_t strides[rank], out_dims[rank];
+    for (size_t a = rank, stride = 1; a-- > 0; stride *= dims[a])
+        strides[a] = stride;
+    for (size_t i = 0; i < rank; i++)
+        out_dims[i] = dims[perm[i]];
+
+    auto y = x.template transpose<TDim...>();
+    for (size_t flat = 0; flat < TensorUtils::get_size<D...>(); flat++)
+    {
+        size_t rest = flat, offset = 0;
+        for (size_t i = rank; i-- > 0;)
+        {
+            offset += rest % out_dims[i] * strides[perm[i]];
+            rest /= out_dims[i];
+        }
+        assert(y.data[flat] == x.data[offset]);
+    }
+}
+
+template <class T, size_t... D>
+Tensor<T, D...> iota()
+{
+    Tensor<T, D...> x;
+    for (size_t i = 0; i < TensorUtils::get_size<D...>(); i++)
+        x.data[i] = (T)i;
+    return x;
+}
+
+void test_permute_plan()
+{
+    // [B, 1, 5, 5, 24, 24] -> [B, 24, 24, 1, 5, 5] is a batch of [25, 576] transposes.
+    constexpr size_t dims[] = {7, 1, 5, 5, 24, 24}, perm[] = {0, 4, 5, 1, 2, 3};
+    constexpr Kernels::PermutePlan plan = Kernels::make_permute_plan(dims, perm, 6);
+    static_assert(plan.rank == 3);
+    static_assert(plan.dims[0] == 7 && plan.dims[1] == 25 && plan.dims[2] == 576);
+    static_assert(plan.dst_strides[0] == 25 * 576 && plan.dst_strides[1] == 1 && plan.dst_strides[2] == 25);
+
+    // The identity collapses to a single copy.
+    constexpr size_t same[] = {0, 1, 2, 3, 4, 5};
+    static_assert(Kernels::make_permute_plan(dims, same, 6).rank == 1);
+}
+
+void test_large_transpose()
+{
+    auto matrix = iota<float, 67, 129>();
+    check_transpose<1, 0>(matrix);
 
+    auto image = iota<float, 13, 4, 24, 24>();
+    check_transpose<1, 2, 3, 0>(image);
+    check_transpose<0, 2, 3, 1>(image);
+    check_transpose<0, 3, 1, 2>(image);
+    check_transpose<3, 2, 1, 0>(image);
+
+    auto windows = iota<float, 9, 1, 5, 5, 24, 24>();
+    check_transpose<0, 4, 5, 1, 2, 3>(windows);
+    check_transpose<0, 1, 2, 3, 4, 5>(windows);
+    check_transpose<2, 0, 1, 5, 3, 4>(windows);
+
+    auto odd = iota<double, 3, 17, 1, 11>();
+    check_transpose<3, 1, 0, 2>(odd);
+    check_transpose<2, 3, 1, 0>(odd);
+
+    // Slices go through the same engine.
+    const auto &view = image;
+    Tensor<float, 24, 24, 4> first = view[3].transpose<1, 2, 0>();
+    for (size_t c = 0; c < 4; c++)
+        for (size_t h = 0; h < 24; h++)
+            for (size_t w = 0; w < 24; w++)
+                assert((first[h][w][c] == image[3][c][h][w]));
+}
+
+int main() {
     static_assert(std::is_same<
         TensorUtils::transpose_helper<Tensor<float, 2, 3, 4, 5>, Transpose<1, 2, 3, 0>>::type,
         Tensor<float, 3, 4, 5, 2>
@@ -64,4 +141,7 @@ int main() {
             for (int k = 0; k < 1; k++)
                 transposed_6_test[i][j][k] = tensor[k][i][j];
     assert(transposed_6 == transposed_6_test);
-}
\ No newline at end of file
+
+    test_permute_plan();
+    test_large_transpose();
+}